@@ -1,61 +1,87 @@
 #include <fstream>
 #include <chrono>
-#include <regex>
-#include <map>
+#include <array>
+#include <cctype>
+#include <string_view>
 
-#include <common/stream.hpp>
 #include <common/time.hpp>
 #include <common/task.hpp>
 
-std::map<std::string, int> digitValue = {
-  { "0", 0 },
-  { "1", 1 },
-  { "2", 2 },
-  { "3", 3 },
-  { "4", 4 },
-  { "5", 5 },
-  { "6", 6 },
-  { "7", 7 },
-  { "8", 8 },
-  { "9", 9 },
-  { "one", 1 },
-  { "two", 2 },
-  { "three", 3 },
-  { "four", 4 },
-  { "five", 5 },
-  { "six", 6 },
-  { "seven", 7 },
-  { "eight", 8 },
-  { "nine", 9 }
-};
+#include <shared/lines.hpp>
+#include <shared/solver.hpp>
+#include <shared/watch.hpp>
+
+namespace day01 {
+
+constexpr std::array<std::string_view, 10> digitNames = { "zero", "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
+
+// Returns the value of the digit or spelled out digit (except for "zero") at the given position or -1 if there is none
+int digitAt(std::string_view line, size_t pos) {
+  if (std::isdigit(line[pos])) {
+    return line[pos] - 0x30;
+  }
+  auto rest = line.substr(pos);
+  for (int value = 1; value < 10; ++value) {
+    if (rest.starts_with(digitNames[value])) {
+      return value;
+    }
+  }
+  return -1;
+}
 
 
+// The calibration values of one line for both parts (0 if the line has no digit for a part)
+Answer calibrationValues(std::string_view line) {
+  Answer values;
+  auto first = line.find_first_of("0123456789");
+  if (first != std::string_view::npos) {
+    values.part1 = (line[first] - 0x30) * 10 + (line[line.find_last_of("0123456789")] - 0x30);
+  }
 
-int main() {
-  common::Time t;
+  // We need two seperate searches for this and we cannot simply iterate over the 
+  // matches as the numbers may overlap i.e. "eighthree"
+  int digit1 = -1, digit2 = -1;
+  for (size_t pos = 0; pos < line.size() && (digit1 = digitAt(line, pos)) < 0; ++pos) {
+  }
+  for (size_t pos = line.size(); pos > 0 && (digit2 = digitAt(line, pos - 1)) < 0; --pos) {
+  }
+  if (digit1 >= 0) {
+    values.part2 = digit1 * 10 + digit2;
+  }
+  return values;
+}
 
-  std::regex firstDigitRegex("([0-9]|one|two|three|four|five|six|seven|eight|nine)");
-  std::regex lastDigitRegex(".*([0-9]|one|two|three|four|five|six|seven|eight|nine)");
-  int calibrationValue = 0;
-  int part2 = 0;
 
-  for (auto line : stream::lines(task::input())) {
-    int digit1 = line[line.find_first_of("0123456789")] - 0x30;
-    int digit2 = line[line.find_last_of("0123456789")] - 0x30;
-    calibrationValue += digit1 * 10 + digit2;
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    for (auto line : text::lines(input)) {
+      lines.push_back(line);
+    }
+  }
 
-    // We need two seperate regexes for this and we cannot simply iterate over the 
-    // matches as the numbers may overlap i.e. "eighthree"
-    std::smatch match;
-    std::regex_search(line, match, firstDigitRegex);
-    digit1 = digitValue[match[1].str()];
-    std::regex_search(line, match, lastDigitRegex);
-    digit2 = digitValue[match[1].str()];
-    part2 += digit1 * 10 + digit2;
+  Answer solve() const override {
+    Answer answer;
+    for (auto& line : lines) {
+      auto values = calibrationValues(line);
+      answer.part1 += values.part1;
+      answer.part2 += values.part2;
+    }
+    return answer;
   }
-  
 
-  std::cout << "Part 1: " << calibrationValue << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  std::vector<std::string_view> lines; // into the input
+};
+
+static solver::Registration<Solution> registration(1);
+
+}
+
+
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string_view(argv[1]) == "--watch") {
+    return watch::run(argv[2], day01::calibrationValues);
+  }
+  return solver::main<day01::Solution>(1, argc, argv);
 }
+#endif
@@ -1,26 +1,30 @@
 #include <iostream>
 #include <fstream>
-#include <regex>
+#include <memory_resource>
+#include <ranges>
+#include <string_view>
 
-#include <common/stream.hpp>
-#include <common/regex.hpp>
-#include <common/split.hpp>
 #include <common/time.hpp>
 #include <common/task.hpp>
 
-std::regex cubeRegex("([0-9]+) ((red)|(green)|(blue))");
+#include <shared/arena.hpp>
+#include <shared/lines.hpp>
+#include <shared/pattern.hpp>
+#include <shared/solver.hpp>
+#include <shared/watch.hpp>
+
+namespace day02 {
 
 struct Cubes {
   Cubes(int r = 0, int g = 0, int b = 0) : r(r), g(g), b(b) {}
   Cubes(std::string_view gamePart) : Cubes() {
-    for (auto cube : regex::iter(gamePart, cubeRegex)) {
-      auto matchStr = cube.str();
-      if (cube[3].matched) { // red
-        r = std::stoi(cube[1].str());
-      } else if (cube[4].matched) { // green
-        g = std::stoi(cube[1].str());
-      } else { // blue
-        b = std::stoi(cube[1].str());
+    for (auto [count, color] : pattern::iter<"{int} {word}">(gamePart)) {
+      if (color == "red") {
+        r = static_cast<int>(count);
+      } else if (color == "green") {
+        g = static_cast<int>(count);
+      } else if (color == "blue") {
+        b = static_cast<int>(count);
       }
     }
   }
@@ -36,41 +40,65 @@ struct Cubes {
   int r, g, b;
 };
 
-std::regex gameRegex("^Game ([0-9]+): (.*)$");
-
 struct Game {
-  Game(const std::string& gameLine) {
-    std::smatch match;
-    std::regex_match(gameLine, match, gameRegex);
-    id = std::stoi(match[1].str());
-    for (auto cubesString : common::split(match[2].str(), "; ")) {
-      cubes.push_back(Cubes(cubesString));
+  // The cubes are allocated from the given memory
+  Game(std::string_view gameLine, std::pmr::memory_resource* memory) : cubes(memory) {
+    auto [gameId, draws] = pattern::match<"Game {int}: {rest}">(gameLine).value();
+    id = static_cast<int>(gameId);
+    for (auto cubesString : draws | std::views::split(std::string_view("; "))) {
+      cubes.push_back(Cubes(std::string_view(cubesString.begin(), cubesString.end())));
     }
   }
 
   int id;
-  std::vector<Cubes> cubes;
+  std::pmr::vector<Cubes> cubes;
 };
 
 
 
-int main()
-{
-  common::Time t;
-  const Cubes LIMITS(12, 13, 14);
+const Cubes LIMITS(12, 13, 14);
 
-  int part1 = 0;
-  int part2 = 0;
-  for (auto gameStr : stream::lines(task::input())) {
-    Game game(gameStr);
-    if (std::ranges::all_of(game.cubes, [&](const Cubes& cubes) { return cubes <= LIMITS; })) {
-      part1 += game.id;
+// The contribution of one game to both parts: its id if it is possible with the LIMITS and the power of its minimal set
+Answer gameValues(const Game& game) {
+  Answer values;
+  if (std::ranges::all_of(game.cubes, [&](const Cubes& cubes) { return cubes <= LIMITS; })) {
+    values.part1 = game.id;
+  }
+  values.part2 = std::ranges::fold_left(game.cubes, Cubes(), [](const Cubes& a, const Cubes& b) { return a.max(b); }).power();
+  return values;
+}
+
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    for (auto gameStr : text::lines(input)) {
+      games.emplace_back(gameStr, arena);
     }
+  }
 
-    part2 += std::ranges::fold_left(game.cubes, Cubes(), [](const Cubes& a, const Cubes& b) { return a.max(b); }).power();
+  Answer solve() const override {
+    Answer answer;
+    for (auto& game : games) {
+      auto values = gameValues(game);
+      answer.part1 += values.part1;
+      answer.part2 += values.part2;
+    }
+    return answer;
   }
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  Arena arena; // holds all cubes, which live as long as the games (declared first to outlive them)
+  std::vector<Game> games;
+};
+
+static solver::Registration<Solution> registration(2);
+
+}
+
+
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string_view(argv[1]) == "--watch") {
+    return watch::run(argv[2], [](std::string_view line) { return day02::gameValues(day02::Game(line, std::pmr::get_default_resource())); });
+  }
+  return solver::main<day02::Solution>(2, argc, argv);
 }
+#endif
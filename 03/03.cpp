@@ -1,17 +1,37 @@
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <spanstream>
+#include <thread>
+#include <vector>
 
 #include <common/time.hpp>
 #include <common/field.hpp>
 #include <common/task.hpp>
 
-struct Engine : public Field {
-  Engine(std::istream&& source) : Field(source) {}
+#include <shared/byte_search.hpp>
+#include <shared/field_view.hpp>
+#include <shared/line_reader.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+
+namespace day03 {
+
+/** The engine schematic on top of a grid type with the FieldT interface: Field copies the grid out of a stream, 
+ *  FieldView reads it directly from the input text
+ */
+template<typename FieldBase>
+struct EngineT : public FieldBase {
+  using FieldBase::FieldBase;
 
   // Returns true if the given position has a non-number symbol != '.' adjacent
   bool hasAdjacentSymbol(Vector pos) const {
     for (auto direction : Vector::AllDirections()) {
-      if (auto value = at(pos + direction)) {
+      if (auto value = this->at(pos + direction)) {
         if (!std::isdigit(*value) && *value != '.') {
           return true;
         }
@@ -29,23 +49,23 @@ struct Engine : public Field {
   }
 
   // Find the first position in the given direction, which is not a valid position or not a digit
-  Vector getNumberEndPos(Vector startPos, Vector direction) {
-    return std::ranges::find_if(rangeFromPositionAndDirection(startPos, direction), [](char ch) { return !std::isdigit(ch); }).pos;
+  Vector getNumberEndPos(Vector startPos, Vector direction) const {
+    return std::ranges::find_if(this->rangeFromPositionAndDirection(startPos, direction), [](char ch) { return !std::isdigit(ch); }).pos;
   }
 
-  std::optional<int> findGearRatio(Vector pos) {
+  std::optional<int> findGearRatio(Vector pos) const {
     // We must collect all surrounding numbers and only return the result if we find exactly two.. but how to restrict the search?
     std::vector<int> numbers;
 
     // First check left of the gear
-    if (std::isdigit(at(pos + Vector::Left, '.'))) {
+    if (std::isdigit(this->at(pos + Vector::Left, '.'))) {
       // Find the start position of the number
       auto startPos = getNumberEndPos(pos + Vector::Left, Vector::Left) + Vector::Right;
       numbers.push_back(rangeToNumber(startPos, pos));
     }
 
     // Now check right of gear
-    if (std::isdigit(at(pos + Vector::Right, '.'))) {
+    if (std::isdigit(this->at(pos + Vector::Right, '.'))) {
       // Find the end position of the number
       auto endPos = getNumberEndPos(pos + Vector::Right, Vector::Right);
       numbers.push_back(rangeToNumber(pos + Vector::Right, endPos));
@@ -54,7 +74,7 @@ struct Engine : public Field {
     // We can have one or two numbers above/below
     auto topPositions = std::vector { pos + Vector::UpLeft, pos + Vector::Up, pos + Vector::UpRight };
     auto topLine = topPositions
-      | std::views::transform([=](auto& pos) { return !!std::isdigit(at(pos, '.')); })
+      | std::views::transform([=](auto& pos) { return !!std::isdigit(this->at(pos, '.')); })
       | std::ranges::to<std::vector>();
 
     // I had to use vector<bool>, because std::isdigit() returned 4 instead of 1, so I couldn't check for equality
@@ -67,7 +87,7 @@ struct Engine : public Field {
       numbers.push_back(rangeToNumber(pos + Vector::UpRight, endPos));
     } else {
       // at most one number on top
-      auto topPos = std::ranges::find_if(topPositions, [=](const Vector& pos) { return std::isdigit(at(pos, '.')); });
+      auto topPos = std::ranges::find_if(topPositions, [=](const Vector& pos) { return std::isdigit(this->at(pos, '.')); });
       if (topPos != topPositions.end()) {
         // exactly one number on top of the gear (find end in both directions)
         auto startPos = getNumberEndPos(*topPos, Vector::Left) + Vector::Right;
@@ -79,7 +99,7 @@ struct Engine : public Field {
     // now the same for below
     auto belowPositions = std::vector{ pos + Vector::DownLeft, pos + Vector::Down, pos + Vector::DownRight };
     auto belowLine = belowPositions
-      | std::views::transform([=](auto& pos) { return !!std::isdigit(at(pos, '.')); })
+      | std::views::transform([=](auto& pos) { return !!std::isdigit(this->at(pos, '.')); })
       | std::ranges::to<std::vector>();
 
     if (belowLine == std::vector { true, false, true }) {
@@ -91,7 +111,7 @@ struct Engine : public Field {
       numbers.push_back(rangeToNumber(pos + Vector::DownRight, endPos));
     } else {
       // at most one number on top
-      auto belowPos = std::ranges::find_if(belowPositions, [=](const Vector& pos) { return std::isdigit(at(pos, '.')); });
+      auto belowPos = std::ranges::find_if(belowPositions, [=](const Vector& pos) { return std::isdigit(this->at(pos, '.')); });
       if (belowPos != belowPositions.end()) {
         // exactly one number on top of the gear (find end in both directions)
         auto startPos = getNumberEndPos(*belowPos, Vector::Left) + Vector::Right;
@@ -106,55 +126,227 @@ struct Engine : public Field {
 
 };
 
+using Engine = EngineT<Field>;
+using EngineView = EngineT<FieldView<char>>;
 
 
-int main() {
-  common::Time t;
-  int part1 = 0;
-  int part2 = 0;
+/** Solves the schematic row by row (e.g. from a pipe) with only three rows in memory. Numbers and gears only reach
+ *  one row up and down, so a row is summed up as soon as the row below it has been pushed:
+ *
+ *    RowWindow window;
+ *    for (auto line : lines) {
+ *      window.push(line);
+ *    }
+ *    auto answer = window.finish();
+ *
+ *  The memory doesn't depend on the height of the schematic, only on its width.
+ */
+class RowWindow {
+public:
+  void push(std::string_view line) {
+    // above <- middle <- below <- line, which reuses the capacity of the rows
+    std::swap(rows[0], rows[1]);
+    std::swap(rows[1], rows[2]);
+    rows[2].assign(line);
+    if (++pushed >= 2) {
+      sumMiddleRow();
+    }
+  }
+
+  // Sums up the last row, call it once after all lines have been pushed
+  Answer finish() {
+    push(""); // an empty row below the last one is outside the schematic
+    return answer;
+  }
 
-  Engine engine(task::input());
-  for (auto row : engine.rows()) {
-    bool hasSymbol = false;
-    int currentNumber = 0;
+private:
+  static bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+  static bool isSymbol(char ch) { return !isDigit(ch) && ch != '.'; }
+
+  void sumMiddleRow() {
+    auto& row = rows[1];
+    for (size_t x = 0; x < row.size();) {
+      if (!isDigit(row[x])) {
+        if (row[x] == '*') {
+          answer.part2 += gearRatio(x);
+        }
+        ++x;
+        continue;
+      }
+
+      auto end = x;
+      auto number = readNumber(row, end);
+      if (hasAdjacentSymbol(x, end)) {
+        answer.part1 += number;
+      }
+      x = end;
+    }
+  }
 
-    // We need the iterator here to get the current position
-    for (auto it = row.begin(), end = row.end(); it != end; ++it) {
-      char symbol = *it;
-      if (std::isdigit(symbol)) {
-        currentNumber = currentNumber * 10 + (symbol - 0x30);
-        if (!hasSymbol && engine.hasAdjacentSymbol(it.pos)) {
-          hasSymbol = true;
+  // Reads the number starting at pos and moves pos behind it
+  static int readNumber(const std::string& row, size_t& pos) {
+    int number = 0;
+    for (; pos < row.size() && isDigit(row[pos]); ++pos) {
+      number = number * 10 + (row[pos] - 0x30);
+    }
+    return number;
+  }
+
+  // Returns true if any row has a symbol in the columns [begin - 1, end], i.e. next to the number in [begin, end)
+  bool hasAdjacentSymbol(size_t begin, size_t end) const {
+    for (auto& row : rows) {
+      for (size_t x = begin ? begin - 1 : 0; x <= end && x < row.size(); ++x) {
+        if (isSymbol(row[x])) {
+          return true;
         }
-      } else if (currentNumber) {
-        // '.' or other symbol following a number
-        if (hasSymbol) {
-          part1 += currentNumber;
+      }
+    }
+    return false;
+  }
+
+  // The product of the numbers adjacent to the '*' in the middle row at x if there are exactly two, otherwise 0
+  int64_t gearRatio(size_t x) const {
+    int count = 0;
+    int64_t product = 1;
+    for (auto& row : rows) {
+      for (size_t column = x ? x - 1 : 0; column <= x + 1 && column < row.size();) {
+        if (!isDigit(row[column])) {
+          ++column;
+          continue;
+        }
+        // The number may start left of the adjacent columns
+        auto begin = column;
+        while (begin > 0 && isDigit(row[begin - 1])) {
+          --begin;
         }
-        // reset for next number
-        currentNumber = 0;
-        hasSymbol = false;
+        product *= readNumber(row, begin);
+        ++count;
+        column = begin; // behind the number
+      }
+    }
+    return (count == 2) ? product : 0;
+  }
+
+  std::string rows[3]; // above, middle, below
+  size_t pushed = 0;
+  Answer answer;
+};
+
+
+
+struct Solution : Solver {
+  static constexpr size_t MinBandSize = 1 << 16; // bytes of text per band, smaller bands don't pay for their thread
+
+  void parse(std::string_view input) override {
+    engine.emplace(input); // the input outlives the solver, so the engine can read the grid directly from it
+  }
+
+  /** The grid is split into horizontal bands of rows, which are solved on their own threads and summed up.
+   *  Numbers never cross rows, so each number and each gear belongs to exactly one band, while the adjacent rows 
+   *  of the neighbouring bands are only read.
+   *  At most Solver::threads bands are used, so batch mode (which sets it to 1) doesn't start threads per file.
+   *  Builds with AOC_TIMERS use a single band as well, because the timer report only covers the calling thread.
+   */
+  Answer solve() const override {
+    auto maxBands = timing::enabled ? 1u : threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    auto rowsPerBand = std::max<size_t>(1, MinBandSize / std::max<size_t>(engine->stride(), 1));
+    auto bandCount = std::clamp<size_t>((engine->height() + rowsPerBand - 1) / rowsPerBand, 1, maxBands);
+    if (bandCount == 1) {
+      return solveRows(0, engine->height());
+    }
+
+    auto bandRows = (engine->height() + static_cast<int>(bandCount) - 1) / static_cast<int>(bandCount);
+    auto firstRow = [&](size_t band) { return std::min(static_cast<int>(band) * bandRows, engine->height()); };
+    std::vector<Answer> answers(bandCount);
+    {
+      std::vector<std::jthread> threads;
+      for (size_t band = 1; band < bandCount; ++band) {
+        threads.emplace_back([&, band] { answers[band] = solveRows(firstRow(band), firstRow(band + 1)); });
       }
+      answers[0] = solveRows(firstRow(0), firstRow(1)); // the calling thread solves the first band
     }
 
-    // Check whether the row ended with a number
-    if (currentNumber && hasSymbol) {
-      part1 += currentNumber;
+    Answer answer;
+    for (auto& bandAnswer : answers) {
+      answer.part1 += bandAnswer.part1;
+      answer.part2 += bandAnswer.part2;
     }
+    return answer;
   }
 
+  // The sum of the part numbers and of the gear ratios in the rows [beginRow, endRow)
+  Answer solveRows(int beginRow, int endRow) const {
+    Answer answer;
+    timing::Scope timer("part1");
+    auto begin = engine->toOffset(Vector(0, beginRow));
+    auto end = engine->toOffset(Vector(0, endRow));
+
+    // Only the digits are visited, which the vectorized search finds without looking at each '.' separately.
+    // Digits of the same number have consecutive offsets, the line breaks separate the numbers of different rows.
+    int currentNumber = 0;
+    bool hasSymbol = false;
+    auto finishNumber = [&] {
+      if (hasSymbol) {
+        answer.part1 += currentNumber;
+      }
+      currentNumber = 0;
+      hasSymbol = false;
+    };
+
+    size_t previousOffset = std::numeric_limits<size_t>::max();
+    for (auto offset : engine->findOffsets(search::ByteClass::range('0', '9'), begin, end)) {
+      if (offset != previousOffset + 1) {
+        finishNumber();
+      }
+      auto pos = engine->fromOffset(offset);
+      currentNumber = currentNumber * 10 + ((*engine)[pos] - 0x30);
+      if (!hasSymbol && engine->hasAdjacentSymbol(pos)) {
+        hasSymbol = true;
+      }
+      previousOffset = offset;
+    }
+    finishNumber();
+
 
-  // Part 2: Start by searching for all '*' symbols and then search for all adjacent numbers
-  for (size_t offset = engine.findOffset('*'); offset != std::numeric_limits<size_t>::max(); offset = engine.findOffset('*', offset+1)) {
-    auto pos = engine.fromOffset(offset);
-    if (auto ratio = engine.findGearRatio(pos)) {
-      part2 += *ratio;
+    // Part 2: Start by searching for all '*' symbols and then search for all adjacent numbers
+    timer.next("part2");
+    for (auto offset : engine->findOffsets('*', begin, end)) {
+      if (auto ratio = engine->findGearRatio(engine->fromOffset(offset))) {
+        answer.part2 += *ratio;
+      }
     }
+
+    return answer;
   }
 
+  std::optional<EngineView> engine;
+};
+
+static solver::Registration<Solution> registration(3);
+
+}
+
+
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 1 && std::string_view(argv[1]) == "--stdin") {
+    // Streaming mode for piped input of any height: each row is summed up while the following blocks are still being read
+    common::Time t;
+    day03::RowWindow window;
+    text::LineReader reader(std::cin);
+    while (auto block = reader.next()) {
+      for (auto line : block->lines()) {
+        window.push(line);
+      }
+    }
+    auto answer = window.finish();
+
+    std::cout << "Part 1: " << answer.part1 << "\n";
+    std::cout << "Part 2: " << answer.part2 << "\n";
+    std::cout << t;
+    return 0;
+  }
 
-  
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+  return solver::main<day03::Solution>(3, argc, argv);
+}
+#endif
@@ -2,33 +2,34 @@
 #include <fstream>
 #include <string_view>
 #include <set>
+#include <memory_resource>
 #include <algorithm>
 #include <numeric>
 #include <ranges>
-#include <regex>
 
 #include <common/time.hpp>
-#include <common/stream.hpp>
-#include <common/regex.hpp>
 #include <common/task.hpp>
 
-std::regex lineRegex("^Card +([0-9]+): (.*?)\\| (.*)$");
-std::regex numberRegex("[0-9]+");
+#include <shared/arena.hpp>
+#include <shared/lines.hpp>
+#include <shared/pattern.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+#include <shared/watch.hpp>
 
-struct Card {
-  Card(std::string line) {
-    auto match = regex::match(line, lineRegex);
-    cardNumber = std::stoi(match[1].str());
-
-    auto winningNumbers = regex::iter(std::string_view(match[2].first, match[2].second), numberRegex)
-      | std::views::transform([](auto& match) { return std::stoi(match[0].str()); })
-      | std::ranges::to<std::set>();
-
-    auto ownNumbers = regex::iter(std::string_view(match[3].first, match[4].second), numberRegex)
-      | std::views::transform([](auto& match) { return std::stoi(match[0].str()); })
-      | std::ranges::to<std::vector>();
+namespace day04 {
 
-    matchCount = std::ranges::count_if(ownNumbers, [&](int number) { return winningNumbers.contains(number); });
+struct Card {
+  // The temporary set of winning numbers is allocated from the given memory
+  Card(std::string_view line, std::pmr::memory_resource* memory) {
+    auto [number, winning, own] = pattern::match<"Card {int}: {ints} | {ints}">(line).value();
+    cardNumber = static_cast<int>(number);
+
+    std::pmr::set<int64_t> winningNumbers(memory);
+    for (auto winningNumber : winning) {
+      winningNumbers.insert(winningNumber);
+    }
+    matchCount = std::ranges::count_if(own, [&](int64_t number) { return winningNumbers.contains(number); });
   }
 
 
@@ -39,42 +40,64 @@ struct Card {
 
   int cardNumber;
   int matchCount; // we only need the match count for both parts
-  int copiesForCard = 0; // the number of copies we receive for this card
 };
 
 
-int main()
-{
-  common::Time t;
-
-  int part1 = 0;
-  std::vector<Card> cards;
-
-  // Part 1
-  for (auto line : stream::lines(task::input())) {
-    cards.emplace_back(std::move(line));
-    part1 += cards.back().value();
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    Arena arena; // for the temporaries of one card at a time
+    for (auto line : text::lines(input)) {
+      cards.emplace_back(line, arena);
+      arena.reset();
+    }
   }
 
-  // Part 2: set the number of copies by iterating backwards (important to avoid costly recursion and reevaluation)
-  for (int i = cards.size() - 1; i >= 0; --i) {
-    auto& card = cards[i];
-    // Add the count of immediately following copies to the count (std::min to ensure we don't copy past the last card)
-    auto followingCopies = std::min(card.matchCount, (static_cast<int>(cards.size()) - 1) - i);
-    card.copiesForCard += followingCopies;
-
-    // Now for each of the following copies add up their copy value fo this card, because we will evaluate them too
-    card.copiesForCard += std::ranges::fold_left(
-      std::views::iota(0, followingCopies) | std::views::transform([&](int offset) { return cards[i + offset + 1].copiesForCard; }),
-      0, std::plus{}
-    );
+  Answer solve() const override {
+    Answer answer;
+
+    // Part 1
+    timing::Scope timer("part1");
+    for (auto& card : cards) {
+      answer.part1 += card.value();
+    }
+
+    // Part 2: set the number of copies by iterating backwards (important to avoid costly recursion and reevaluation)
+    timer.next("part2");
+    std::vector<int> copiesForCard(cards.size()); // the number of copies we receive for each card
+    for (int i = cards.size() - 1; i >= 0; --i) {
+      auto& card = cards[i];
+      // Add the count of immediately following copies to the count (std::min to ensure we don't copy past the last card)
+      auto followingCopies = std::min(card.matchCount, (static_cast<int>(cards.size()) - 1) - i);
+      copiesForCard[i] += followingCopies;
+
+      // Now for each of the following copies add up their copy value fo this card, because we will evaluate them too
+      copiesForCard[i] += std::ranges::fold_left(
+        std::views::iota(0, followingCopies) | std::views::transform([&](int offset) { return copiesForCard[i + offset + 1]; }),
+        0, std::plus{}
+      );
+    }
+
+    // Count up the copiesForCard (+1 for the card itself)
+    answer.part2 = std::ranges::fold_left(copiesForCard | std::views::transform([](int copies) { return copies + 1; }), 0, std::plus{});
+    return answer;
   }
 
-  // Count up the copiesForCard (+1 for the card itself)
-  auto part2 = std::ranges::fold_left(cards | std::views::transform([](const Card& card) { return card.copiesForCard + 1; }), 0, std::plus{});
+  std::vector<Card> cards;
+};
+
+static solver::Registration<Solution> registration(4);
+
+}
 
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string_view(argv[1]) == "--watch") {
+    // Only part 1 is a sum over the cards, the copies of part 2 depend on the following cards
+    return watch::run(argv[2], [](std::string_view line) { 
+      return Answer { .part1 = day04::Card(line, std::pmr::get_default_resource()).value() };
+    }, false);
+  }
+  return solver::main<day04::Solution>(4, argc, argv);
+}
+#endif
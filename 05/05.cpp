@@ -4,12 +4,19 @@
 #include <ranges>
 #include <cassert>
 #include <limits>
+#include <span>
+#include <spanstream>
 
 #include <common/time.hpp>
 #include <common/stream.hpp>
-#include <common/regex.hpp>
 #include <common/task.hpp>
 
+#include <shared/pattern.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+
+namespace day05 {
+
 struct Range {
   Range(int64_t begin, int64_t end) : begin(begin), end(end) {}
   int64_t begin, end; // begin; end as usually defined for iterators
@@ -55,7 +62,6 @@ struct MapEntry {
 };
 
 
-std::regex rangeRegex("([0-9]+) ([0-9]+) ([0-9]+)");
 struct Map {
   Map(std::string from, std::string to) : from(std::move(from)), to(std::move(to)) {}
   Map(std::string from, std::string to, std::istream& input) : from(std::move(from)), to(std::move(to)) {
@@ -64,8 +70,8 @@ struct Map {
         break; // end of map section
       }
 
-      auto match = regex::match(line, rangeRegex);
-      map.emplace_back(std::stoll(match[1].str()), std::stoll(match[2].str()), std::stoll(match[3].str()));
+      auto [destination, source, length] = pattern::match<"{int} {int} {int}">(line).value();
+      map.emplace_back(destination, source, length);
     }
 
     // Finally the range entries
@@ -128,6 +134,11 @@ struct Map {
 
   // apply the map to the given value
   int64_t operator()(int64_t value) const {
+    return apply(map, value);
+  }
+
+  // apply normalized map entries to the given value
+  static int64_t apply(std::span<const MapEntry> map, int64_t value) {
     // Use binary search to find the MapEntry, whose source.end range is AFTER the value i.e. the range should include the value
     // We should always find a value
     auto pos = std::upper_bound(map.begin(), map.end(), value, [](int64_t value, const MapEntry& entry) { return value < entry.source.end; });
@@ -185,32 +196,16 @@ struct Map {
   std::vector<MapEntry> map; // <- sorted ascending by sourceBegin
 };
 
-std::regex numberRegex("[0-9]+");
-std::regex mapRegex("([a-z]+)-to-([a-z]+) map:$");
-
-struct Almanac {
-  Almanac(std::istream&& input) : combined("<INVALID>", "<INVALID>") {
-    auto seedLine = stream::line(input);
-    for (auto& match : regex::iter(seedLine, numberRegex)) {
-      seeds.push_back(std::stoll(match[0].str()));
-    }
-    
-    stream::line(input); // read empty line
-    while (auto match = regex::match(stream::line(input), mapRegex)) {
-      maps.emplace_back(match[1].str(), match[2].str(), input);
-    }
-
-    // Combine all maps into one complete map
-    combined = Map::combine(maps[0], maps[1]);
-    for (auto pos = maps.begin() + 2, end = maps.end(); pos != end; ++pos) {
-      combined = Map::combine(combined, *pos);
-    }
-  }
+/** Everything both parts need: the seeds and the combined map. It either refers to a parsed Almanac or to a snapshot.
+ */
+struct Locations {
+  std::span<const int64_t> seeds;
+  std::span<const MapEntry> combined; // normalized
 
   /** Returns the location value for a given seed (i.e) pass it through the combined map
    */
   int64_t getLocation(int64_t seedValue) const {
-    return combined(seedValue);
+    return Map::apply(combined, seedValue);
   }
 
   int64_t minLocation() const {
@@ -221,7 +216,7 @@ struct Almanac {
   int64_t minLocationForRange(Range range) const {
     // Simply check all overlapping ranges.
     auto minLocation = std::numeric_limits<int64_t>::max();
-    for (auto& mapEntry : combined.map) {
+    for (auto& mapEntry : combined) {
       if (range.overlaps(mapEntry.source)) {
         // We only check .begin of the overlapped range, because we cannot get a smaller value later
         auto minMapped = range.overlap(mapEntry.source).begin + mapEntry.offset;
@@ -239,6 +234,40 @@ struct Almanac {
     }
     return minLocation;
   }
+};
+
+
+struct Almanac {
+  Almanac() : combined("<INVALID>", "<INVALID>") {}
+  Almanac(std::istream&& input) : combined("<INVALID>", "<INVALID>") {
+    auto seedLine = stream::line(input);
+    auto [seedNumbers] = pattern::match<"seeds: {ints}">(seedLine).value();
+    seeds = seedNumbers | std::ranges::to<std::vector>();
+    
+    stream::line(input); // read empty line
+    for (auto mapLine = stream::line(input); auto match = pattern::match<"{word}-to-{word} map:">(mapLine); mapLine = stream::line(input)) {
+      auto [from, to] = *match;
+      maps.emplace_back(std::string(from), std::string(to), input);
+    }
+
+    // Combine all maps into one complete map
+    timing::Scope timer("combine");
+    combined = Map::combine(maps[0], maps[1]);
+    for (auto pos = maps.begin() + 2, end = maps.end(); pos != end; ++pos) {
+      combined = Map::combine(combined, *pos);
+    }
+  }
+
+  Locations locations() const {
+    return Locations { seeds, combined.map };
+  }
+
+  int64_t getLocation(int64_t seedValue) const {
+    return combined(seedValue);
+  }
+
+  int64_t minLocation() const { return locations().minLocation(); }
+  int64_t minLocationForRanges() const { return locations().minLocationForRanges(); }
 
 
 
@@ -249,15 +278,49 @@ struct Almanac {
 
 
 
-int main()
-{
-  common::Time t;
-  
-  Almanac almanac(task::input());
-  auto minLocation = almanac.minLocation();
-  auto minRangeLocation = almanac.minLocationForRanges();
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    almanac = Almanac(std::ispanstream(input));
+    locations = almanac.locations();
+  }
+
+  Answer solve() const override {
+    Answer answer;
+    timing::Scope timer("part1");
+    answer.part1 = locations.minLocation();
+    timer.next("part2");
+    answer.part2 = locations.minLocationForRanges();
+    return answer;
+  }
+
+  // Only the seeds and the combined map are stored, the individual maps aren't needed to solve
+  bool save(snapshot::Writer& writer) const override {
+    writer.tag("day05/1");
+    writer.array(locations.seeds);
+    writer.array(locations.combined);
+    return true;
+  }
+
+  bool load(snapshot::Reader& reader) override {
+    if (!reader.tag("day05/1")) {
+      return false;
+    }
+    locations.seeds = reader.array<int64_t>();
+    locations.combined = reader.array<MapEntry>();
+    return true;
+  }
+
+  Almanac almanac; // empty if loaded from a snapshot
+  Locations locations; // into the almanac or the snapshot
+};
+
+static solver::Registration<Solution> registration(5);
+
+}
+
 
-  std::cout << "Part 1: " << minLocation << "\n";
-  std::cout << "Part 2: " << minRangeLocation << "\n";
-  std::cout << t;
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  return solver::main<day05::Solution>(5, argc, argv);
 }
+#endif
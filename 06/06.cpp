@@ -1,22 +1,28 @@
 #include <vector>
 #include <numeric>
+#include <spanstream>
 
 #include <common/time.hpp>
 #include <common/task.hpp>
 #include <common/stream.hpp>
 
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+
+namespace day06 {
+
 
 
 struct Race {
   int64_t time;
   int64_t record;
 
-  int64_t distance(int64_t buttonTime) {
+  int64_t distance(int64_t buttonTime) const {
     int64_t raceTime = std::min<int64_t>(time - buttonTime, 0);
     return raceTime * buttonTime /* here buttonTime is the speed */;
   }
 
-  std::pair<int64_t, int64_t> minMaxValues() {
+  std::pair<int64_t, int64_t> minMaxValues() const {
     // If we ignore negative speeds, then the above equation is:
     // d = (time - button) * button
     //   = time*button - button*button
@@ -45,7 +51,7 @@ struct Race {
 
   /** Returns the number of ways we have to beat this concrete record
    */
-  int64_t calcNumOptions() {
+  int64_t calcNumOptions() const {
     auto [minDuration, maxDuration] = minMaxValues();
     return maxDuration - minDuration + 1;
   }
@@ -70,7 +76,7 @@ private:
 };
 
 
-std::vector<Race> parseInput(std::ifstream&& input) {
+std::vector<Race> parseInput(std::istream&& input) {
   std::istringstream times(stream::line(input));
   std::istringstream records(stream::line(input));
 
@@ -97,23 +103,34 @@ std::vector<Race> parseInput(std::ifstream&& input) {
 
 
 
-int main() {
-  common::Time t;
-
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    races = parseInput(std::ispanstream(input));
+  }
 
-  auto races = parseInput(task::input());
+  Answer solve() const override {
+    Answer answer { .part1 = 1 };
+    timing::Scope timer("part1");
+    for (auto& race : races) {
+      answer.part1 *= race.calcNumOptions();
+    }
 
-  int64_t part1 = 1;
-  for (auto& race : races) {
-    part1 *= race.calcNumOptions();
+    timer.next("part2");
+    auto fullRace = std::accumulate(races.begin() + 1, races.end(), *races.begin(), Race::merge);
+    answer.part2 = fullRace.calcNumOptions();
+    return answer;
   }
 
+  std::vector<Race> races;
+};
 
-  auto fullRace = std::accumulate(races.begin() + 1, races.end(), *races.begin(), Race::merge);
-  auto part2 = fullRace.calcNumOptions();
+static solver::Registration<Solution> registration(6);
 
+}
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
-}
\ No newline at end of file
+
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  return solver::main<day06::Solution>(6, argc, argv);
+}
+#endif
@@ -1,21 +1,30 @@
 #include <map>
 #include <algorithm>
+#include <array>
+#include <span>
+#include <spanstream>
 
 #include <common/time.hpp>
 #include <common/task.hpp>
 #include <common/stream.hpp>
 
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
 
-std::vector<char> cardOrder = { '2', '3', '4', '5', '6', '7', '8', '9', 'T', 'J', 'Q', 'K', 'A' };
+namespace day07 {
 
-int cardValue(char card) {
-  return std::distance(cardOrder.begin(), std::find(cardOrder.begin(), cardOrder.end(), card));
+const std::vector<char> cardOrder = { '2', '3', '4', '5', '6', '7', '8', '9', 'T', 'J', 'Q', 'K', 'A' };
+const std::vector<char> jokerCardOrder = { 'J', '2', '3', '4', '5', '6', '7', '8', '9', 'T', 'Q', 'K', 'A' }; // card order for part 2
+
+int cardValue(char card, const std::vector<char>& order) {
+  return std::distance(order.begin(), std::find(order.begin(), order.end(), card));
 }
 
 
 
 struct Hand {
   std::array<char, 5> cards;
+  std::array<int, 5> values; // card values according to the current card order (compared instead of the cards)
   int bid;
   enum Strength : int {
     HighCard,
@@ -28,7 +37,7 @@ struct Hand {
   } strength;
 
 
-  Strength calcStrength(bool maxStrength = false) {
+  Strength calcStrength(bool maxStrength = false) const {
     // To determine the hand, simply count occurrences:
     std::vector<std::pair<char, int>> occurrences;
 
@@ -68,15 +77,22 @@ struct Hand {
     }
   }
 
+  // Updates strength and card values according to the rules of part 1 or part 2 (jokers)
+  void evaluate(bool jokerRules) {
+    strength = calcStrength(jokerRules);
+    auto& order = jokerRules ? jokerCardOrder : cardOrder;
+    for (size_t i = 0; i < cards.size(); ++i) {
+      values[i] = cardValue(cards[i], order);
+    }
+  }
+
   // Compare hands by strength, then by first, second, ... card
   bool operator<(const Hand& other) const {
     if (strength != other.strength) {
       return strength < other.strength;
     }
 
-    return std::lexicographical_compare(cards.begin(), cards.end(), other.cards.begin(), other.cards.end(), [](char cardA, char cardB) {
-      return cardValue(cardA) < cardValue(cardB);
-    });
+    return values < other.values; // lexicographical comparison
   }
 };
 
@@ -86,7 +102,7 @@ std::istream& operator>>(std::istream& in, Hand& hand) {
     in >> card;
   }
   in >> hand.bid;
-  hand.strength = hand.calcStrength();
+  hand.evaluate(false);
   return in;
 }
 
@@ -103,45 +119,71 @@ std::vector<Hand> readHands(std::istream&& input) {
 }
 
 
-int main() {
-  common::Time t;
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    parsedHands = readHands(std::ispanstream(input));
+    hands = parsedHands;
+  }
+
+  Answer solve() const override {
+    Answer answer;
 
-  auto hands = readHands(task::input());
-  std::sort(hands.begin(), hands.end());
+    // Part 1
+    timing::Scope timer("part1");
+    auto sortedHands = std::vector<Hand>(hands.begin(), hands.end());
+    std::sort(sortedHands.begin(), sortedHands.end());
 
+    int rank = 0;
+    for (auto& hand : sortedHands) {
+      answer.part1 += hand.bid * ++rank;
+    }
 
-  // Part 1
-  int64_t part1 = 0;
-  int rank = 0;
-  for (auto& hand : hands) {
-    part1 += hand.bid * ++rank;
-  }
 
+    // Part 2
+    timer.next("part2");
 
+    // Update strength and card values according to new rules
+    for (auto& hand : sortedHands) {
+      hand.evaluate(true);
+    }
 
-  // Part 2
-  
-  // Update strength according to new rules
-  for (auto& hand : hands) {
-    hand.strength = hand.calcStrength(true);
-  }
+    // Sort again according to new hand strengths and card ordering
+    std::sort(sortedHands.begin(), sortedHands.end());
 
-  // Set new card order for sorting
-  cardOrder = { 'J', '2', '3', '4', '5', '6', '7', '8', '9', 'T', 'Q', 'K', 'A' };
+    rank = 0;
+    for (auto& hand : sortedHands) {
+      answer.part2 += hand.bid * ++rank;
+    }
 
-  // Sort again according to new hand strengths and card ordering
-  std::sort(hands.begin(), hands.end());
+    return answer;
+  }
 
+  // The hands are stored evaluated for part 1, like parse() leaves them
+  bool save(snapshot::Writer& writer) const override {
+    writer.tag("day07/1");
+    writer.array(hands);
+    return true;
+  }
 
-  // Part 1
-  int64_t part2 = 0;
-  rank = 0;
-  for (auto& hand : hands) {
-    part2 += hand.bid * ++rank;
+  bool load(snapshot::Reader& reader) override {
+    if (!reader.tag("day07/1")) {
+      return false;
+    }
+    hands = reader.array<Hand>();
+    return true;
   }
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  std::vector<Hand> parsedHands; // empty if loaded from a snapshot
+  std::span<const Hand> hands;   // into parsedHands or the snapshot
+};
+
+static solver::Registration<Solution> registration(7);
+
+}
 
-}
\ No newline at end of file
+
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  return solver::main<day07::Solution>(7, argc, argv);
+}
+#endif
@@ -1,24 +1,31 @@
-#include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <deque>
+#include <limits>
 #include <numeric>
+#include <string_view>
 
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/stream.hpp>
-#include <common/regex.hpp>
-#include <common/hash.hpp>
 
+#include <shared/flat_hash.hpp>
+#include <shared/hash.hpp>
+#include <shared/lines.hpp>
+#include <shared/pattern.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
 
+namespace day08 {
 
 struct Node {
-  std::string id;
+  std::string_view id; // into the input
 
-  Node* left;
-  Node* right;
+  Node* left = nullptr;
+  Node* right = nullptr;
 
 
-  Node* get(char instruction) {
+  Node* get(char instruction) const {
     // only 'L' and 'R' allowed:
     return (instruction == 'L') ? left : right;
   }
@@ -26,53 +33,65 @@ struct Node {
   bool isGhostEndNode() const {
     return id.back() == 'Z';
   }
+};
 
-  static void loadNodes(std::istream& input) {
-    std::regex lineRegex("^([A-Z0-9]+) = \\(([A-Z0-9]+), ([A-Z0-9]+)\\)$");
-    for (auto line : stream::lines(input)) {
-      if (auto result = regex::match(line, lineRegex)) {
-        auto& node = nodes[result[1]]; // implicitly create the node if not already done
-        node.id = result[1];
-        node.left = &nodes[result[2]]; // implicitly create the referenced node if not already done
-        node.right = &nodes[result[3]];
-      }
+
+/** All nodes indexed by their id. The nodes are kept in a deque, so that they keep their addresses for the left/right pointers.
+ */
+struct Network {
+  void load(std::string_view line) {
+    if (auto result = pattern::match<"{word} = ({word}, {word})">(line)) {
+      auto [id, left, right] = *result;
+      auto& node = get(id);
+      node.left = &get(left);
+      node.right = &get(right);
     }
   }
 
+  // Returns the node with the given id and implicitly creates it if not already done
+  Node& get(std::string_view id) {
+    auto [pos, inserted] = index.try_emplace(id, nullptr);
+    if (inserted) {
+      pos->second = &nodes.emplace_back(Node { .id = id });
+    }
+    return *pos->second;
+  }
+
+  const Node* find(std::string_view id) const {
+    auto pos = index.find(id);
+    return (pos != index.end()) ? pos->second : nullptr;
+  }
+
   // Returns all ghost starting nodes as a vector
-  static std::vector<Node*> ghostStartNodes() {
-    std::vector<Node*> result;
-    for (auto& [id, node] : nodes) {
-      if (id.back() == 'A') {
+  std::vector<const Node*> ghostStartNodes() const {
+    std::vector<const Node*> result;
+    for (auto& node : nodes) {
+      if (node.id.back() == 'A') {
         result.push_back(&node);
       }
     }
     return result;
   }
 
-  static std::unordered_map<std::string, Node> nodes;
+  std::deque<Node> nodes;
+  flat::Map<std::string_view, Node*> index;
 };
 
-std::unordered_map<std::string, Node> Node::nodes;
-
 
 struct LoopEntry {
-  LoopEntry(Node* node, size_t index, int instructionIndex) : node(node), index(index), instructionIndex(instructionIndex) {}
+  LoopEntry(const Node* node, size_t index, int instructionIndex) : node(node), index(index), instructionIndex(instructionIndex) {}
 
-  Node* node;
+  const Node* node;
   size_t index;
   int instructionIndex;
   
 
   bool operator==(const LoopEntry& other) const { return node == other.node && instructionIndex == other.instructionIndex; }
   bool operator!=(const LoopEntry& other) const { return node != other.node || instructionIndex != other.instructionIndex; }
-};
 
-template<>
-struct std::hash<LoopEntry> {
-  size_t operator()(const LoopEntry& entry) const { 
-    return hash_all(entry.node, entry.instructionIndex);
-  }
+  struct Hash {
+    size_t operator()(const LoopEntry& entry) const { return hashing::combine(entry.node, entry.instructionIndex); }
+  };
 };
 
 
@@ -82,11 +101,12 @@ struct NodeLoop {
   size_t zOffset; // Offset of node ending in 'Z' relative to loop head (only 1 in my input)
 
 
-  static NodeLoop calculate(Node* node, const std::string& instructions) {
+  static NodeLoop calculate(const Node* node, const std::string& instructions) {
     // Try to determine the loop head and the loop length
-    std::unordered_set<LoopEntry> loopSet;
+    timing::Scope timer("loop detection");
+    flat::Set<LoopEntry, LoopEntry::Hash> loopSet;
     std::vector<size_t> zIndicies;
-    std::vector<Node*> visitedNodes; // kinda expensive for the large input, but is necessary to determine the "real" period for sample2.txt
+    std::vector<const Node*> visitedNodes; // kinda expensive for the large input, but is necessary to determine the "real" period for sample2.txt
 
     NodeLoop loop;
     for (size_t index = 0, instruction = 0;; ++index, ++instruction) {
@@ -141,7 +161,7 @@ struct NodeLoop {
   /** This method takes all visited nodes and tries to find a smaller period than the current one
    *  This step is only needed to solve for the "sample2.txt" data.
    */
-  void reducePeriod(std::vector<Node*> visitedNodes) {
+  void reducePeriod(std::vector<const Node*> visitedNodes) {
     visitedNodes.erase(visitedNodes.begin(), visitedNodes.begin() + head);
 
     // Now find all occurences of the loop's start node inside the visited nodes and try to trace a loop until the end.
@@ -164,67 +184,134 @@ std::ostream& operator<<(std::ostream& out, const NodeLoop& loop) {
 }
 
 
-int main() {
-  common::Time t;
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    auto lines = text::lines(input);
+    auto line = lines.begin();
+    instructions = *line++;
+    ++line; // ignore second line
+    for (; line != lines.end(); ++line) {
+      network.load(*line); // load all nodes
+    }
+  }
 
-  auto input = task::input();
-  auto instructions = stream::line(input);
-  stream::line(input); // ignore second line
-  Node::loadNodes(input); // load all nodes
+  Answer solve() const override {
+    Answer answer;
+    timing::Scope timer("part1");
+
+    if (auto start = network.find("AAA")) { // <- only here to not crash when running it with "sample2.txt"
+      auto node = start;
+      for (int instructionIx = 0; node->id != "ZZZ"; instructionIx = (instructionIx+1) % instructions.length()) {
+        node = node->get(instructions[instructionIx]);
+        ++answer.part1;
+      }
+    }
 
 
-  int part1 = 0;
-  if (Node::nodes.count("AAA")) { // <- only here to not crash when running it with "sample2.txt"
-    auto node = &Node::nodes["AAA"];
-    for (int instructionIx = 0; node->id != "ZZZ"; instructionIx = (instructionIx+1) % instructions.length()) {
-      node = node->get(instructions[instructionIx]);
-      ++part1;
+    // Part 2 is actually pretty challenging:
+    // The pure brute force approach works for the sample, but leads nowhere for the input with 50.000.000.000 steps tried so far.
+    // 
+    // My input consists of 730 Nodes and a chain of 270 instructions.
+    // Since each node has two outputs any set of instructions will eventually end up in a loop.
+    // The longest possible loop would have the length 730*270 = 197.100, which we exceeded by far with out brute force attempt.
+    // 
+    // So the approach is to find all start nodes and for each start node determine, when the loop starts and what the loop period is.
+    // For example something like A -> B -> C -> Z -> Z would have a loop head of 3 and a period of 1 because it loops into one state.
+    // Then we will note down all 'Z' states inside the looping part.
+    // 
+    // We have 6 start states in our input, so that is doable and takes about 300ms in Debug with the current approach.
+    // 
+    // There are two observations from these results, which truely simplify the task at hand:
+    // 1. for my input there is only exactly one 'Z' state in any such loop, which simplifies what follows.
+    // 2. for my input head+zOffset equals period (which is not at all general, but simplifies the calculation by a LOT)
+    // 
+    // Thanks to the data loop layout (having the 'Z' node exactly at the end of the loop), we only have to take 
+    // the least common multiple of all periods and we are done.
+
+
+
+
+    // Find all start nodes
+    timer.next("part2");
+    auto startNodes = network.ghostStartNodes();
+
+    // Calculate the loops
+    std::vector<NodeLoop> loops;
+    for (auto node : startNodes) {
+      loops.push_back(NodeLoop::calculate(node, instructions));
     }
+
+    // Calculate least common mulitple of all loop periods
+    answer.part2 = std::accumulate(loops.begin() + 1, loops.end(), loops[0].period, [](size_t total, const NodeLoop& loop) { return std::lcm(total, loop.period); });
+    return answer;
   }
 
-  
+  /** The nodes are stored as their ids and the indices of their left and right nodes, so loading skips matching the
+   *  lines and looking up the left and right nodes. The ids are read directly from the snapshot.
+   */
+  bool save(snapshot::Writer& writer) const override {
+    flat::Map<const Node*, uint32_t> numbers;
+    numbers.reserve(network.nodes.size());
+    for (auto& node : network.nodes) {
+      numbers.try_emplace(&node, static_cast<uint32_t>(numbers.size()));
+    }
 
+    auto number = [&](const Node* node) { return node ? numbers.find(node)->second : NoNode; };
+    std::vector<std::array<uint32_t, 2>> links;
+    for (auto& node : network.nodes) {
+      links.push_back({ number(node.left), number(node.right) });
+    }
 
-  // Part 2 is actually pretty challenging:
-  // The pure brute force approach works for the sample, but leads nowhere for the input with 50.000.000.000 steps tried so far.
-  // 
-  // My input consists of 730 Nodes and a chain of 270 instructions.
-  // Since each node has two outputs any set of instructions will eventually end up in a loop.
-  // The longest possible loop would have the length 730*270 = 197.100, which we exceeded by far with out brute force attempt.
-  // 
-  // So the approach is to find all start nodes and for each start node determine, when the loop starts and what the loop period is.
-  // For example something like A -> B -> C -> Z -> Z would have a loop head of 3 and a period of 1 because it loops into one state.
-  // Then we will note down all 'Z' states inside the looping part.
-  // 
-  // We have 6 start states in our input, so that is doable and takes about 300ms in Debug with the current approach.
-  // 
-  // There are two observations from these results, which truely simplify the task at hand:
-  // 1. for my input there is only exactly one 'Z' state in any such loop, which simplifies what follows.
-  // 2. for my input head+zOffset equals period (which is not at all general, but simplifies the calculation by a LOT)
-  // 
-  // Thanks to the data loop layout (having the 'Z' node exactly at the end of the loop), we only have to take 
-  // the least common multiple of all periods and we are done.
+    writer.tag("day08/1");
+    writer.string(instructions);
+    writer.array(links);
+    for (auto& node : network.nodes) {
+      writer.string(node.id);
+    }
+    return true;
+  }
 
-  
-  // Find all start nodes
-  auto nodes = Node::ghostStartNodes();
+  bool load(snapshot::Reader& reader) override {
+    if (!reader.tag("day08/1")) {
+      return false;
+    }
+    auto storedInstructions = reader.string();
+    auto links = reader.array<std::array<uint32_t, 2>>();
+    std::vector<std::string_view> ids;
+    for (size_t i = 0; i < links.size(); ++i) {
+      ids.push_back(reader.string());
+    }
+    auto valid = [&](uint32_t number) { return number < ids.size() || number == NoNode; };
+    if (!std::ranges::all_of(links, [&](auto& link) { return valid(link[0]) && valid(link[1]); })) {
+      return false;
+    }
 
-  // Calculate the loops
-  std::vector<NodeLoop> loops;
-  for (auto node : nodes) {
-    loops.push_back(NodeLoop::calculate(node, instructions));
+    instructions = storedInstructions;
+    network.index.reserve(ids.size());
+    for (auto id : ids) {
+      network.get(id);
+    }
+    auto node = [&](uint32_t number) { return (number != NoNode) ? &network.nodes[number] : nullptr; };
+    for (size_t i = 0; i < links.size(); ++i) {
+      network.nodes[i].left = node(links[i][0]);
+      network.nodes[i].right = node(links[i][1]);
+    }
+    return true;
   }
 
-  // Display the detected loops
-  for (auto& loop : loops) {
-    std::cout << loop << "\n";
-  }
+  static constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max(); // nodes without a line of their own
+
+  std::string instructions;
+  Network network;
+};
+
+static solver::Registration<Solution> registration(8);
 
-  // Calculate least common mulitple of all loop periods
-  auto part2 = std::accumulate(loops.begin() + 1, loops.end(), loops[0].period, [](size_t total, const NodeLoop& loop) { return std::lcm(total, loop.period); });
+}
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
 
-}
\ No newline at end of file
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  return solver::main<day08::Solution>(8, argc, argv);
+}
+#endif
@@ -1,15 +1,25 @@
 #include <cassert>
 #include <algorithm>
+#include <memory_resource>
+#include <span>
+#include <spanstream>
 
 #include <common/time.hpp>
 #include <common/task.hpp>
-#include <common/stream.hpp>
 
+#include <shared/arena.hpp>
+#include <shared/line_reader.hpp>
+#include <shared/lines.hpp>
+#include <shared/solver.hpp>
+#include <shared/watch.hpp>
 
-std::vector<int> parseLine(const std::string& line) {
-  std::istringstream input(line);
+namespace day09 {
 
-  std::vector<int> numbers;
+
+std::pmr::vector<int> parseLine(std::string_view line, std::pmr::memory_resource* memory = std::pmr::get_default_resource()) {
+  std::ispanstream input(line);
+
+  std::pmr::vector<int> numbers(memory);
   do {
     int number;
     if (input >> number) {
@@ -20,9 +30,9 @@ std::vector<int> parseLine(const std::string& line) {
   return numbers;
 }
 
-std::vector<int> adjacentDifference(const std::vector<int>& numbers) {
+std::pmr::vector<int> adjacentDifference(std::span<const int> numbers, std::pmr::memory_resource* memory) {
   assert(!numbers.empty());
-  std::vector<int> difference;
+  std::pmr::vector<int> difference(memory);
   difference.reserve(numbers.size() - 1);
   for (auto pos = numbers.begin(), end = numbers.end() - 1; pos != end; ++pos) {
     difference.push_back(pos[1] - pos[0]);
@@ -30,35 +40,80 @@ std::vector<int> adjacentDifference(const std::vector<int>& numbers) {
   return difference;
 }
 
-std::pair<int, int> calculatePreviousAndNext(const std::vector<int>& numbers) {
-  auto difference = adjacentDifference(numbers);
+// All difference sequences are allocated from the given memory
+std::pair<int, int> calculatePreviousAndNext(std::span<const int> numbers, std::pmr::memory_resource* memory) {
+  auto difference = adjacentDifference(numbers, memory);
   if (std::ranges::all_of(difference, [](int value) { return value == 0; })) {
     return std::make_pair(numbers.front(), numbers.back()); // + 0
   } else {
-    auto [previous, next] = calculatePreviousAndNext(difference);
+    auto [previous, next] = calculatePreviousAndNext(difference, memory);
     return std::make_pair(numbers.front() - previous, numbers.back() + next);
   }
 }
 
 
 
-int main() {
-  common::Time t;
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    for (auto line : text::lines(input)) {
+      sequences.push_back(parseLine(line));
+    }
+  }
+
+  Answer solve() const override {
+    Answer answer;
+    Arena arena; // for the difference sequences of one sequence at a time
+    for (auto& numbers : sequences) {
+      auto [previous, next] = calculatePreviousAndNext(numbers, arena);
+      answer.part1 += next;
+      answer.part2 += previous;
+      arena.reset();
+    }
+    return answer;
+  }
+
+  std::vector<std::pmr::vector<int>> sequences;
+};
+
+static solver::Registration<Solution> registration(9);
 
+}
 
-  int part1 = 0;
-  int part2 = 0;
 
-  for (auto line : stream::lines(task::input())) {
-    auto numbers = parseLine(line);
-    auto [previous, next] = calculatePreviousAndNext(numbers);
-    part1 += next;
-    part2 += previous;
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 1 && std::string_view(argv[1]) == "--stdin") {
+    // Streaming mode for piped input: each line is solved while the following blocks are still being read
+    common::Time t;
+    Answer answer;
+    Arena arena;
+    text::LineReader reader(std::cin);
+    while (auto block = reader.next()) {
+      for (auto line : block->lines()) {
+        auto [previous, next] = day09::calculatePreviousAndNext(day09::parseLine(line, arena), arena);
+        answer.part1 += next;
+        answer.part2 += previous;
+        arena.reset();
+      }
+    }
+
+    std::cout << "Part 1: " << answer.part1 << "\n";
+    std::cout << "Part 2: " << answer.part2 << "\n";
+    std::cout << t;
+    return 0;
   }
 
-  
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  if (argc > 2 && std::string_view(argv[1]) == "--watch") {
+    return watch::run(argv[2], [](std::string_view line) {
+      auto numbers = day09::parseLine(line);
+      if (numbers.empty()) {
+        return Answer(); // a line being written
+      }
+      auto [previous, next] = day09::calculatePreviousAndNext(numbers, std::pmr::get_default_resource());
+      return Answer { next, previous };
+    });
+  }
 
-}
\ No newline at end of file
+  return solver::main<day09::Solution>(9, argc, argv);
+}
+#endif
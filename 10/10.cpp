@@ -1,11 +1,27 @@
 #include <cassert>
-#include <unordered_set>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iostream>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <spanstream>
+#include <string_view>
 
 #include <common/time.hpp>
 #include <common/task.hpp>
 #include <common/field.hpp>
 #include <common/vector.hpp>
 
+#include <shared/field_view.hpp>
+#include <shared/flat_hash.hpp>
+#include <shared/mapped_file.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+
+namespace day10 {
+
 enum class Kind : char {
   UpDown = '|',
   LeftRight = '-',
@@ -18,101 +34,192 @@ enum class Kind : char {
 };
 
 
-struct Tile {
-  Tile(char ch) : kind(static_cast<Kind>(ch)) {}
-  Tile(Kind kind) : kind(kind) {}
+// Directions in clockwise order, so that (direction + 1) % 4 rotates clockwise and (direction + 2) % 4 reverses the direction
+enum Direction : int8_t {
+  Up,
+  Right,
+  Down,
+  Left,
+  Stuck = -1 // no valid exit
+};
 
-  /** Returns the exit to take if we follow the pipe segment from the place we entered
-   *  Returns none if we cannot enter the segment from this direction, or this is the ground or start segment
-   */
-  std::optional<Vector> getExit(const Vector& enteredFrom) const {
-    auto vectors = connections();
-    if (enteredFrom == vectors.first) {
-      return vectors.second;
-    } else if (enteredFrom == vectors.second) {
-      return vectors.first;
-    } else {
-      return std::nullopt;
+constexpr uint8_t directionBit(int direction) {
+  return static_cast<uint8_t>(1 << direction);
+}
+
+Vector toVector(Direction direction) {
+  switch (direction) {
+    case Up: return Vector::Up;
+    case Right: return Vector::Right;
+    case Down: return Vector::Down;
+    case Left: return Vector::Left;
+    default: return Vector::Zero;
+  }
+}
+
+// Returns the pipe segment's connections as a bit mask of directions (ground and start state have 0 connections for simplicity)
+constexpr uint8_t connectionMask(Kind kind) {
+  switch (kind) {
+    case Kind::UpDown: return directionBit(Up) | directionBit(Down);
+    case Kind::UpRight: return directionBit(Up) | directionBit(Right);
+    case Kind::UpLeft: return directionBit(Up) | directionBit(Left);
+    case Kind::LeftRight: return directionBit(Left) | directionBit(Right);
+    case Kind::DownRight: return directionBit(Down) | directionBit(Right);
+    case Kind::DownLeft: return directionBit(Down) | directionBit(Left);
+    default: return 0;
+  }
+}
+
+/** Lookup table for the exit to take if we follow a pipe segment, indexed by the segment's connection mask and the direction 
+ *  we moved in to enter it. Yields Stuck if we cannot enter the segment from this direction.
+ */
+constexpr auto exitTable = [] {
+  std::array<std::array<Direction, 4>, 16> table = {};
+  for (unsigned mask = 0; mask < 16; ++mask) {
+    for (int entry = Up; entry <= Left; ++entry) {
+      auto entrySide = directionBit((entry + 2) % 4); // we enter the segment through the side opposite to our movement
+      table[mask][entry] = (std::popcount(mask) == 2 && (mask & entrySide)) ? static_cast<Direction>(std::countr_zero(mask & ~entrySide)) : Stuck;
     }
   }
+  return table;
+}();
+
+
+struct Tile {
+  Tile(char ch) : kind(static_cast<Kind>(ch)) {}
+  Tile(Kind kind) : kind(kind) {}
 
   bool operator==(const Tile& other) const {
     return kind == other.kind;
   }
 
-  // Returns the pipe segment's connections (ground and startstate have 0 connnections for simplicity)
-  std::pair<Vector, Vector> connections() const {
-    switch (kind) {
-      case Kind::UpDown: return std::make_pair(Vector::Up, Vector::Down);
-      case Kind::UpRight: return std::make_pair(Vector::Up, Vector::Right);
-      case Kind::UpLeft: return std::make_pair(Vector::Up, Vector::Left);
-      case Kind::LeftRight: return std::make_pair(Vector::Left, Vector::Right);
-      case Kind::DownRight: return std::make_pair(Vector::Down, Vector::Right);
-      case Kind::DownLeft: return std::make_pair(Vector::Down, Vector::Left);
-      default: return std::make_pair(Vector::Zero, Vector::Zero);
-    }
+  uint8_t connections() const {
+    return connectionMask(kind);
   }
 
   Kind kind;
 };
 
 
+/** Bit-packed boolean grid indexed by field offsets
+ */
+struct BitGrid {
+  BitGrid(size_t size = 0) : words((size + 63) / 64) {}
+
+  bool test(size_t offset) const { return (words[offset / 64] >> (offset % 64)) & 1; }
+  void set(size_t offset) { words[offset / 64] |= uint64_t(1) << (offset % 64); }
+
+  std::vector<uint64_t> words;
+};
+
+
 struct Loop {
-  std::vector<Vector> positions;
+  std::vector<size_t> offsets; // field offsets of the loop in traversal order (starting with the start tile)
+  BitGrid tiles; // loop membership for each field offset
+  uint8_t startConnections = 0; // inferred pipe segment below the start tile
   int clockWiseness = 0; // positive if loop spins clockwise, negative if counter clockwise
 
-  Vector rotateInwards(Vector direction) const {
-    return clockWiseness > 0 ? direction.rotateCW() : direction.rotateCCW();
+  bool contains(size_t offset) const { return tiles.test(offset); }
+
+  Direction rotateInwards(Direction direction) const {
+    return static_cast<Direction>((direction + (clockWiseness > 0 ? 1 : 3)) % 4);
   }
 };
 
 
-struct PipeField : FieldT<Tile> {
-  PipeField(std::istream&& input) : FieldT(std::move(input)) {}
+template<typename FieldBase>
+constexpr bool isFieldView = false;
 
-  Vector getStartPos() const {
-    return fromOffset(findOffset(Kind::Start));
-  }
+template<typename T>
+constexpr bool isFieldView<FieldView<T>> = true;
 
 
-  Loop findLoop(Vector startPos) {
-    // We will only check 
-    for (auto direction : Vector::AllSimpleDirections()) {
-      if (auto loop = calcLoop(startPos, direction)) {
-        return *loop;
+/** The pipe field on top of a grid type with the FieldT interface: FieldT<Tile> copies the grid out of a stream, 
+ *  FieldView<Tile> reads it directly from the input text. The offsets used below are the text offsets for FieldView
+ *  (including the line breaks, which have no connections) and y * width + x for FieldT. The connection masks are
+ *  looked up on demand, so a FieldView is never copied.
+ */
+template<typename FieldBase>
+struct PipeFieldT : FieldBase {
+  template<typename Source>
+  PipeFieldT(Source&& source) : FieldBase(std::forward<Source>(source)) {
+    if constexpr (isFieldView<FieldBase>) {
+      stride = static_cast<ptrdiff_t>(FieldBase::stride());
+      tileCount = static_cast<size_t>(this->height()) * stride;
+    } else {
+      // The copied grid has no line breaks, so a row is as long as the field is wide
+      for (auto row : this->rows()) {
+        stride = 0;
+        for ([[maybe_unused]] auto tile : row) {
+          ++stride;
+        }
+        tileCount += stride;
       }
     }
+  }
+
+  // Connection mask of the tile at the offset, read directly from the underlying storage
+  uint8_t connections(size_t offset) const {
+    if constexpr (isFieldView<FieldBase>) {
+      return connectionMask(static_cast<Kind>(this->data()[offset]));
+    } else {
+      return this->data[offset].connections(); // the offsets of FieldT index its tiles
+    }
+  }
 
-    assert(false); // no loop?
-    return {};
+  size_t getStartOffset() const {
+    auto pos = this->fromOffset(this->findOffset(Kind::Start));
+    return pos.y * stride + pos.x;
   }
 
 
-  /** Finds the loop when starting in the given direction
+  /** Infers the pipe segment below the start tile from the neighbouring tiles, which connect back to it
    */
-  std::optional<Loop> calcLoop(Vector startPos, Vector direction) const {
-    Loop loop;
-    loop.positions.push_back(startPos);
-    for (Vector pos = startPos + direction; pos != startPos; pos += direction) {
-      loop.positions.push_back(pos);
-      if (auto nextTile = at(pos)) {
-        // A valid tile
-        if (auto nextDirection = nextTile->getExit(direction * -1)) {
-          // Connected in the correct direction
-          if (nextDirection == direction.rotateCW()) {
-            ++loop.clockWiseness;
-          } else if (nextDirection == direction.rotateCCW()) {
-            --loop.clockWiseness;
-          }
-
-          direction = *nextDirection;
-        } else {
-          return std::nullopt;
+  uint8_t inferStartConnections(size_t startOffset) const {
+    auto startPos = Vector(static_cast<int>(startOffset % stride), static_cast<int>(startOffset / stride));
+    uint8_t result = 0;
+    for (int direction = Up; direction <= Left; ++direction) {
+      if (auto neighbour = this->at(startPos + toVector(static_cast<Direction>(direction)))) {
+        if (neighbour->connections() & directionBit((direction + 2) % 4)) {
+          result |= directionBit(direction);
         }
-      } else {
-        return std::nullopt; // left the field
       }
     }
+
+    assert(std::popcount(result) == 2); // otherwise the start tile's shape is ambiguous
+    return result;
+  }
+
+
+  /** Follows the loop once from the start tile, leaving it through its first inferred connection
+   */
+  Loop findLoop(size_t startOffset) const {
+    Loop loop;
+    loop.tiles = BitGrid(tileCount);
+    loop.startConnections = inferStartConnections(startOffset);
+
+    const std::array<ptrdiff_t, 4> steps = { -stride, 1, stride, -1 }; // offset change for each direction
+
+    auto direction = static_cast<Direction>(std::countr_zero(loop.startConnections));
+    auto offset = startOffset;
+    do {
+      loop.offsets.push_back(offset);
+      loop.tiles.set(offset);
+
+      offset += steps[direction];
+      auto mask = (offset == startOffset) ? loop.startConnections : connections(offset);
+      auto nextDirection = exitTable[mask][direction];
+      assert(nextDirection != Stuck); // pipe isn't connected in the direction we came from
+
+      if (nextDirection == (direction + 1) % 4) {
+        ++loop.clockWiseness;
+      } else if (nextDirection == (direction + 3) % 4) {
+        --loop.clockWiseness;
+      }
+
+      direction = nextDirection;
+    } while (offset != startOffset);
+
     return loop;
   }
 
@@ -122,26 +229,26 @@ struct PipeField : FieldT<Tile> {
     // follow the loop one more time and at each segment go in the direction of the inside of the loop
     // (the clockwiseness direction) and collect all fields in a set, which are in that direction before
     // touching another field that belongs to the loop itself.
-    std::unordered_set<Vector> loopFields(loop.positions.begin(), loop.positions.end());
-    std::unordered_set<Vector> enclosedFields;
+    // The loop's offsets are already in its membership bitmap, so only the enclosed fields need a set
+    flat::Set<size_t> enclosedFields;
 
-    Vector lastDirection = Vector::Zero;
-    Vector lastPosition = *loop.positions.begin();
-    for (auto it = loop.positions.begin() + 1, end = loop.positions.end(); it != end; ++it) {
-      auto position = *it;
-      auto direction = position - lastPosition;
+    Direction lastDirection = Stuck;
+    size_t lastOffset = loop.offsets.front();
+    for (auto it = loop.offsets.begin() + 1, end = loop.offsets.end(); it != end; ++it) {
+      auto offset = *it;
+      auto direction = directionBetween(lastOffset, offset);
 
       if (direction == lastDirection) {
         // We entered this field in the same direction as we entered the previous one, which means that the previous one must 
         // have been a straight pipe. Turn the direction vector in clockwiseness direction and search for enclosed 
-        collectEnclosedInDirection(lastPosition, loop.rotateInwards(direction), loopFields, enclosedFields);
+        collectEnclosedInDirection(lastOffset, loop.rotateInwards(direction), loop, enclosedFields);
       } else if (loop.rotateInwards(direction) == lastDirection) {
         // We rotated outwards of the loop, so we have a cornering piece with two edges facing the inside of the loop, we must check both directions
-        collectEnclosedInDirection(lastPosition, loop.rotateInwards(direction), loopFields, enclosedFields);
-        collectEnclosedInDirection(lastPosition, direction * -1, loopFields, enclosedFields); // *-1 = rotate inwards twice
+        collectEnclosedInDirection(lastOffset, loop.rotateInwards(direction), loop, enclosedFields);
+        collectEnclosedInDirection(lastOffset, static_cast<Direction>((direction + 2) % 4), loop, enclosedFields); // = rotate inwards twice
       }
 
-      lastPosition = position;
+      lastOffset = offset;
       lastDirection = direction;
     }
 
@@ -149,30 +256,269 @@ struct PipeField : FieldT<Tile> {
   }
 
 
-  void collectEnclosedInDirection(Vector startPos, Vector direction, const std::unordered_set<Vector>& loopFields, std::unordered_set<Vector>& enclosedFields) const {
-    for (auto position = startPos + direction; !loopFields.contains(position); position += direction) {
-      assert(validPosition(position)); // we cannot actually leave the loop/field if the search in the clockwiseness direction
-      enclosedFields.insert(position);
+  void collectEnclosedInDirection(size_t startOffset, Direction direction, const Loop& loop, flat::Set<size_t>& enclosedFields) const {
+    for (auto offset = startOffset + step(direction); !loop.contains(offset); offset += step(direction)) {
+      assert(offset < tileCount); // we cannot actually leave the loop/field if the search in the clockwiseness direction
+      enclosedFields.insert(offset);
+    }
+  }
+
+
+  // Offset change for moving one tile in the given direction
+  ptrdiff_t step(Direction direction) const {
+    const std::array<ptrdiff_t, 4> steps = { -stride, 1, stride, -1 };
+    return steps[direction];
+  }
+
+  // Direction of the move between two adjacent offsets
+  Direction directionBetween(size_t from, size_t to) const {
+    auto difference = static_cast<ptrdiff_t>(to - from);
+    return (difference == -stride) ? Up : (difference == 1) ? Right : (difference == stride) ? Down : Left;
+  }
+
+
+  ptrdiff_t stride = 0; // offset difference between two rows
+  size_t tileCount = 0; // number of offsets (height * stride)
+};
+
+
+using PipeField = PipeFieldT<FieldT<Tile>>;
+using PipeFieldView = PipeFieldT<FieldView<Tile>>;
+
+
+/** Index for "is this tile inside the loop?" queries. For each row it stores the sorted columns of all loop tiles, which 
+ *  connect upwards. Crossing such a tile toggles between outside and inside of the loop. Tiles, which only connect downwards
+ *  don't count, so that "L--7" counts as one crossing and "L--J" as none.
+ *  The index keeps its own copy of the loop membership, so it doesn't depend on the lifetime of the loop.
+ */
+struct LoopIndex {
+  template<typename PipeField>
+  LoopIndex(const PipeField& field, const Loop& loop) : tiles(loop.tiles), stride(field.stride), crossings(field.tileCount / field.stride) {
+    auto startOffset = loop.offsets.front();
+    for (auto offset : loop.offsets) {
+      auto mask = (offset == startOffset) ? loop.startConnections : field.connections(offset);
+      if (mask & directionBit(Up)) {
+        crossings[offset / stride].push_back(offset % stride);
+      }
+    }
+
+    // We collected the columns in traversal order
+    for (auto& row : crossings) {
+      std::ranges::sort(row);
+    }
+  }
+
+  // Returns true if the tile at (x, y) is enclosed by the loop (loop tiles themselves are not enclosed)
+  // @pre (x, y) is a valid position of the field
+  bool contains(size_t x, size_t y) const {
+    if (tiles.test(y * stride + x)) {
+      return false;
+    }
+
+    auto& row = crossings[y];
+    auto crossed = std::distance(row.begin(), std::ranges::lower_bound(row, x));
+    return crossed % 2 == 1;
+  }
+
+  /** Calls callback(x) for each enclosed tile in row y by scanning the row's crossings in pairs. 
+   *  Everything between an odd and the following even crossing is inside the loop unless it is part of the loop.
+   */
+  template<typename Callback>
+  void forEachInRow(size_t y, Callback&& callback) const {
+    auto& row = crossings[y];
+    for (size_t i = 0; i + 1 < row.size(); i += 2) {
+      for (auto x = row[i] + 1; x < row[i + 1]; ++x) {
+        if (!tiles.test(y * stride + x)) {
+          callback(x);
+        }
+      }
+    }
+  }
+
+  size_t countInRow(size_t y) const {
+    size_t count = 0;
+    forEachInRow(y, [&](size_t) { ++count; });
+    return count;
+  }
+
+  size_t count() const {
+    size_t count = 0;
+    for (size_t y = 0; y < crossings.size(); ++y) {
+      count += countInRow(y);
+    }
+    return count;
+  }
+
+
+  BitGrid tiles; // loop membership by offset
+  size_t stride;
+  std::vector<std::vector<size_t>> crossings; // sorted columns of vertical crossings for each row
+};
+
+
+/** Solves both parts directly on the input text without loading it into a field. The only allocation is the loop 
+ *  membership bitmap (one bit per tile), so this works on grids which are way too large for PipeField/Loop.
+ */
+struct PipeScanner {
+  PipeScanner(std::string_view text) : text(text) {
+    width = std::min(text.find('\n'), text.size());
+    stride = width + 1; // rows include the line break
+    if (width > 0 && text[width - 1] == '\r') {
+      --width; // CRLF line endings
+    }
+    height = (text.size() + stride - 1) / stride; // last line may lack the line break
+  }
+
+  uint8_t connections(size_t offset) const {
+    return (offset == startOffset) ? startConnections : connectionMask(static_cast<Kind>(text[offset]));
+  }
+
+  // Returns the offset of the neighbouring tile in the given direction or npos if that would leave the grid
+  size_t neighbour(size_t offset, int direction) const {
+    auto x = offset % stride;
+    auto y = offset / stride;
+    switch (direction) {
+      case Up: return (y > 0) ? offset - stride : std::string_view::npos;
+      case Right: return (x + 1 < width) ? offset + 1 : std::string_view::npos;
+      case Down: return (y + 1 < height) ? offset + stride : std::string_view::npos;
+      case Left: return (x > 0) ? offset - 1 : std::string_view::npos;
+      default: return std::string_view::npos;
+    }
+  }
+
+  /** Follows the loop from the start tile, marks all loop tiles and returns the loop's length
+   */
+  size_t traceLoop() {
+    startOffset = text.find(static_cast<char>(Kind::Start));
+    assert(startOffset != std::string_view::npos);
+
+    // Infer the start tile's shape from the neighbours, which connect back to it
+    startConnections = 0;
+    for (int direction = Up; direction <= Left; ++direction) {
+      auto offset = neighbour(startOffset, direction);
+      if (offset != std::string_view::npos && (connections(offset) & directionBit((direction + 2) % 4))) {
+        startConnections |= directionBit(direction);
+      }
+    }
+    assert(std::popcount(startConnections) == 2);
+
+    loopTiles = BitGrid(height * stride);
+    const std::array<ptrdiff_t, 4> steps = { -static_cast<ptrdiff_t>(stride), 1, static_cast<ptrdiff_t>(stride), -1 };
+
+    size_t length = 0;
+    auto direction = static_cast<Direction>(std::countr_zero(startConnections));
+    auto offset = startOffset;
+    do {
+      loopTiles.set(offset);
+      ++length;
+      offset += steps[direction];
+      direction = exitTable[connections(offset)][direction];
+      assert(direction != Stuck);
+    } while (offset != startOffset);
+
+    return length;
+  }
+
+  /** Counts the enclosed tiles row by row. Each loop tile with an upwards connection toggles between outside and inside.
+   *  @pre traceLoop() has been called
+   */
+  size_t countEnclosed() const {
+    size_t count = 0;
+    for (size_t y = 0; y < height; ++y) {
+      bool inside = false;
+      for (size_t offset = y * stride, end = offset + width; offset != end; ++offset) {
+        if (loopTiles.test(offset)) {
+          inside ^= (connections(offset) & directionBit(Up)) != 0;
+        } else if (inside) {
+          ++count;
+        }
+      }
     }
+    return count;
+  }
+
+
+  std::string_view text;
+  size_t width, stride, height;
+  size_t startOffset = std::string_view::npos;
+  uint8_t startConnections = 0;
+  BitGrid loopTiles;
+};
+
+
+struct Solution : Solver {
+  void parse(std::string_view input) override {
+    field.emplace(input); // the input outlives the solver, so the field can read the tiles directly from it
+  }
+
+  Answer solve() const override {
+    timing::Scope timer("part1");
+    auto loop = field->findLoop(field->getStartOffset());
+
+    Answer answer;
+    answer.part1 = (loop.offsets.size() + 1) / 2; // round up
+    timer.next("part2");
+    answer.part2 = field->countEnclosedFields(loop);
+    assert(static_cast<int64_t>(LoopIndex(*field, loop).count()) == answer.part2); // both approaches must agree
+    return answer;
   }
 
+  std::optional<PipeFieldView> field;
 };
 
+static solver::Registration<Solution> registration(10);
 
-int main() {
-  common::Time t;
+}
 
-  PipeField field(task::input());
-  
-  auto startPos = field.getStartPos();
-  auto loop = field.findLoop(startPos);
 
-  int part1 = (loop.positions.size() + 1) / 2; // round up
-  int part2 = field.countEnclosedFields(loop);
+#ifndef AOC_DRIVER
+int main(int argc, char* argv[]) {
+  if (argc > 2 && std::string_view(argv[1]) == "--stream") {
+    // Streaming mode for huge grids: scan the memory mapped file given as second argument
+    common::Time t;
+    MappedFile input(argv[2]);
+    day10::PipeScanner scanner(input.view());
+    auto part1 = (scanner.traceLoop() + 1) / 2; // round up
+    auto part2 = scanner.countEnclosed();
 
+    std::cout << "Part 1: " << part1 << "\n";
+    std::cout << "Part 2: " << part2 << "\n";
+    std::cout << t;
+    return 0;
+  }
 
-  std::cout << "Part 1: " << part1 << "\n";
-  std::cout << "Part 2: " << part2 << "\n";
-  std::cout << t;
+  if (argc > 1 && std::string_view(argv[1]) == "--inside") {
+    // Query mode: reads "X Y" lines (is the tile enclosed?) or "Y" lines (which tiles of the row are enclosed?) from stdin
+    solver::Input input(solver::inputPath(10));
+    day10::PipeFieldView field(input.view());
+    auto loop = field.findLoop(field.getStartOffset());
+    day10::LoopIndex index(field, loop);
+
+    for (std::string line; std::getline(std::cin, line);) {
+      std::ispanstream query(line);
+      int x = 0, y = 0;
+      if (!(query >> x)) {
+        continue;
+      }
+      if (!(query >> y)) {
+        // only a row was given
+        y = x;
+        if (!field.validPosition(Vector(0, y))) {
+          std::cout << y << ": invalid row\n";
+          continue;
+        }
+        std::cout << y << ":";
+        index.forEachInRow(y, [](size_t column) { std::cout << " " << column; });
+        std::cout << "\n";
+      } else if (!field.validPosition(Vector(x, y))) {
+        std::cout << x << " " << y << ": invalid position\n";
+      } else {
+        std::cout << x << " " << y << ": " << (index.contains(x, y) ? "inside" : "outside") << "\n";
+      }
+    }
+    return 0;
+  }
 
-}
\ No newline at end of file
+  return solver::main<day10::Solution>(10, argc, argv);
+}
+#endif
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <regex>
+
+#include <common/stream.hpp>
+
+#include "benchmark.hpp"
+
+
+struct Timings {
+  double min = 0;
+  double median = 0;
+  double p95 = 0;
+};
+
+
+// Matches a duration like "12.5ms" in the time line printed by common::Time
+std::regex durationRegex("([0-9]+(\\.[0-9]+)?) ?(ns|us|\xC2\xB5s|ms|s)\\b");
+
+/** Returns the runtime in milliseconds, which the task reported on the first line containing a duration after its
+ *  part results. That's the line printed by common::Time, anything after it (like the timer tree of AOC_TIMERS builds)
+ *  is ignored. The part results are skipped too, because they may look like durations.
+ */
+std::optional<double> reportedTime(const std::string& output) {
+  std::optional<double> result;
+  for (auto line : stream::lines(std::istringstream(output))) {
+    std::smatch match;
+    if (line.find("Part") != std::string::npos) {
+      result.reset(); // the time follows the results
+    } else if (!result && std::regex_search(line, match, durationRegex)) {
+      auto value = std::stod(match[1].str());
+      auto unit = match[3].str();
+      if (unit == "ns") {
+        value /= 1e6;
+      } else if (unit == "us" || unit == "\xC2\xB5s") {
+        value /= 1e3;
+      } else if (unit == "s") {
+        value *= 1e3;
+      }
+      result = value;
+    }
+  }
+  return result;
+}
+
+
+// Calculates the statistics using the nearest rank method
+Timings calcTimings(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  auto rank = [&](double percentile) {
+    auto index = static_cast<size_t>(std::ceil(percentile * samples.size()));
+    return samples[std::clamp<size_t>(index, 1, samples.size()) - 1];
+  };
+  return Timings { .min = samples.front(), .median = rank(0.5), .p95 = rank(0.95) };
+}
+
+
+/** Baseline file format (same style as results.txt): 
+ *    // comment
+ *    <task>,<min>,<median>,<p95>     (all times in milliseconds)
+ */
+std::map<int, Timings> readBaseline(const std::string& path) {
+  std::map<int, Timings> baseline;
+  for (auto line : stream::lines(std::ifstream(path))) {
+    if (line.empty() || line.starts_with("//")) {
+      continue;
+    }
+    std::istringstream lineStream(line);
+    int taskNr;
+    char comma;
+    Timings timings;
+    if (lineStream >> taskNr >> comma >> timings.min >> comma >> timings.median >> comma >> timings.p95) {
+      baseline[taskNr] = timings;
+    }
+  }
+  return baseline;
+}
+
+void writeBaseline(const std::string& path, const std::map<int, Timings>& timings) {
+  std::ofstream out(path);
+  out << "// task,min,median,p95 (milliseconds)\n";
+  for (auto& [taskNr, entry] : timings) {
+    out << taskNr << "," << entry.min << "," << entry.median << "," << entry.p95 << "\n";
+  }
+}
+
+
+int runBenchmark(const std::vector<int>& taskNumbers, const Options& options) {
+  auto benchOptions = options;
+  benchOptions.jobs = 1;
+
+  auto baseline = readBaseline(options.baselinePath);
+  std::map<int, Timings> results;
+  int regressions = 0;
+
+  std::cout << "\nBenchmark (" << options.warmupRuns << " warmup + " << options.benchRuns << " runs, milliseconds):\n";
+  std::cout << "     min       median    p95       baseline\n";
+  for (auto taskNr : taskNumbers) {
+    std::vector<double> samples;
+    for (int run = 0; run < options.warmupRuns + options.benchRuns; ++run) {
+      auto result = runTasks({ taskNr }, benchOptions).front();
+      if (run >= options.warmupRuns) {
+        // Prefer the time measured by the task itself as it excludes the process startup
+        samples.push_back(reportedTime(result.output).value_or(result.wallTime));
+      }
+    }
+
+    auto timings = results[taskNr] = calcTimings(std::move(samples));
+    std::cout << std::setfill('0') << std::setw(2) << taskNr << ": " << std::setfill(' ') << std::fixed << std::setprecision(3)
+      << std::setw(9) << timings.min << " " << std::setw(9) << timings.median << " " << std::setw(9) << timings.p95;
+
+    if (auto pos = baseline.find(taskNr); pos != baseline.end()) {
+      auto change = (timings.median / pos->second.median - 1.0) * 100.0;
+      std::cout << " " << std::setw(9) << pos->second.median << " (" << std::showpos << std::setprecision(1) << change << "%" << std::noshowpos << ")";
+      if (change > options.threshold) {
+        std::cout << " REGRESSION";
+        ++regressions;
+      }
+    }
+    std::cout << "\n";
+  }
+
+  if (baseline.empty() || options.saveBaseline) {
+    writeBaseline(options.baselinePath, results);
+    std::cout << "Wrote baseline to " << options.baselinePath << "\n";
+  }
+
+  std::cout << regressions << " Regressions!\n";
+  return regressions;
+}
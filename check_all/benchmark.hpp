@@ -0,0 +1,10 @@
+#pragma once
+#include <vector>
+
+#include "runner.hpp"
+
+/** Runs each task options.warmupRuns + options.benchRuns times (one task at a time to not disturb the measurements)
+ *  and prints min/median/p95 of the measured runs. The medians are compared against the baseline file.
+ *  Returns the number of tasks, which regressed by more than options.threshold percent.
+ */
+int runBenchmark(const std::vector<int>& taskNumbers, const Options& options);
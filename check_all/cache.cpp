@@ -0,0 +1,93 @@
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iomanip>
+
+#include "cache.hpp"
+
+
+// 64 bit FNV-1a hash of the file's contents
+std::optional<uint64_t> hashFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::nullopt;
+  }
+
+  uint64_t hash = 0xcbf29ce484222325;
+  char buf[65536];
+  while (file.read(buf, sizeof(buf)) || file.gcount()) {
+    for (auto pos = buf, end = buf + file.gcount(); pos != end; ++pos) {
+      hash = (hash ^ static_cast<uint8_t>(*pos)) * 0x100000001b3;
+    }
+  }
+  return hash;
+}
+
+
+std::optional<CacheKey> cacheKey(int taskNr, const Options& options) {
+  if (Options::limitFor(options.memoryLimits, taskNr) || Options::limitFor(options.cpuLimits, taskNr)) {
+    return std::nullopt; // a limited run may fail or behave differently, so it must neither use nor replace the cached result
+  }
+  auto executableHash = hashFile(taskExecutable(taskNr, options));
+  auto inputHash = hashFile(std::format("../data/{:02d}/input.txt", taskNr));
+  if (!executableHash || !inputHash) {
+    return std::nullopt;
+  }
+  return CacheKey { .executableHash = *executableHash, .inputHash = *inputHash };
+}
+
+
+/** The cache file consists of one entry per task:
+ *    <task> <executable hash> <input hash> <exit code> <wall time> <user time> <system time> <peak RSS> <minor faults> <major faults> <voluntary switches> <involuntary switches> <output size>\n
+ *    <output>\n
+ */
+ResultCache::ResultCache(std::string path) : path(std::move(path)) {
+  std::ifstream file(this->path, std::ios::binary);
+  for (;;) {
+    CacheKey key;
+    TaskRun run;
+    auto& usage = run.usage;
+    size_t outputSize;
+    file >> run.taskNr >> std::hex >> key.executableHash >> key.inputHash >> std::dec >> run.exitCode >> run.wallTime
+      >> usage.userTime >> usage.systemTime >> usage.peakRss >> usage.minorFaults >> usage.majorFaults 
+      >> usage.voluntarySwitches >> usage.involuntarySwitches >> outputSize;
+    if (!file || file.get() != '\n') {
+      break;
+    }
+
+    run.output.resize(outputSize);
+    if (!file.read(run.output.data(), outputSize) || file.get() != '\n') {
+      break; // truncated cache file -> ignore the rest
+    }
+    entries[run.taskNr] = std::make_pair(key, std::move(run));
+  }
+}
+
+
+std::optional<TaskRun> ResultCache::find(int taskNr, const CacheKey& key) const {
+  auto pos = entries.find(taskNr);
+  if (pos == entries.end() || pos->second.first != key) {
+    return std::nullopt;
+  }
+
+  auto run = pos->second.second;
+  run.cached = true;
+  return run;
+}
+
+
+void ResultCache::store(const TaskRun& run, const CacheKey& key) {
+  entries[run.taskNr] = std::make_pair(key, run);
+}
+
+
+void ResultCache::save() const {
+  std::ofstream file(path, std::ios::binary);
+  for (auto& [taskNr, entry] : entries) {
+    auto& [key, run] = entry;
+    auto& usage = run.usage;
+    file << taskNr << " " << std::hex << key.executableHash << " " << key.inputHash << std::dec << " " << run.exitCode << " " << run.wallTime
+      << " " << usage.userTime << " " << usage.systemTime << " " << usage.peakRss << " " << usage.minorFaults << " " << usage.majorFaults
+      << " " << usage.voluntarySwitches << " " << usage.involuntarySwitches << " " << run.output.size() << "\n" << run.output << "\n";
+  }
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+
+#include "runner.hpp"
+
+/** Identifies a task result by the contents of the task's executable and its input file
+ */
+struct CacheKey {
+  uint64_t executableHash = 0;
+  uint64_t inputHash = 0;
+
+  bool operator==(const CacheKey&) const = default;
+};
+
+
+// Returns the cache key of the given task or nullopt if its executable or input cannot be read or the task runs
+// with a memory or CPU limit (such runs are never cached)
+std::optional<CacheKey> cacheKey(int taskNr, const Options& options);
+
+
+/** Persistent cache of the last result of each task, which is only valid as long as neither the task's
+ *  executable nor its input changed.
+ */
+struct ResultCache {
+  ResultCache(std::string path);
+
+  std::optional<TaskRun> find(int taskNr, const CacheKey& key) const;
+  void store(const TaskRun& run, const CacheKey& key);
+  void save() const;
+
+  std::string path;
+  std::map<int, std::pair<CacheKey, TaskRun>> entries; // by task number
+};
@@ -5,89 +5,20 @@
 #include <regex>
 #include <cassert>
 #include <thread>
+#include <filesystem>
 #include <iomanip>
+#include <map>
+#include <string_view>
 
 #include <common/stream.hpp>
 
-#include <windows.h>
+#include "runner.hpp"
+#include "benchmark.hpp"
+#include "cache.hpp"
 
 std::regex resultsRegex("^(//.*)|(\"([^\"]+)\"|([^,]+))(,(\"([^\"]+)\"|(.*)))?$");
 std::vector<std::optional<std::pair<std::string, std::optional<std::string>>>> results;
 
-#ifdef _DEBUG
-#define CONFIG "Debug"
-#else
-#define CONFIG "Release"
-#endif
-
-
-std::string getTaskOutput(int taskNumber) {
-  SECURITY_ATTRIBUTES pipeSecurityAttributes = {
-    .nLength = sizeof(SECURITY_ATTRIBUTES),
-    .bInheritHandle = TRUE 
-  };
-  HANDLE readPipe, writePipe;
-  BOOL success = CreatePipe(
-    &readPipe, // hReadPipe
-    &writePipe, // hWritePipe
-    &pipeSecurityAttributes, // lpPipeAttributes
-    0); // nSize (0 means default)
-  assert(success);
-
-  std::string output;
-
-  auto readingThreadFunc = [readPipe, &output]() {
-    char buf[256];
-    for (;;) {
-      DWORD bytesRead;
-      BOOL ok = ReadFile(readPipe, buf, sizeof(buf), &bytesRead, NULL);
-      if (ok) {
-        output.append(buf, bytesRead);
-      } else {
-        return;
-      }
-    }
-  };
-  std::thread readingThread { readingThreadFunc };
-
-  STARTUPINFOA startupInfo = {
-      .cb = sizeof(STARTUPINFOA),
-      .dwFlags = STARTF_USESTDHANDLES,
-      .hStdInput = INVALID_HANDLE_VALUE,
-      .hStdOutput = writePipe,
-      .hStdError = writePipe
-  };
-  PROCESS_INFORMATION processInfo = {};
-
-  std::string taskId = std::format("{:02d}", taskNumber);
-  auto exePath = "..\\x64\\" CONFIG "\\" + taskId + ".exe";
-  auto workDir = "..\\" + taskId + "\\";
-
-  success = CreateProcessA(
-    exePath.c_str(), // lpApplicationName
-    NULL, // lpCommandLine
-    NULL, // lpProcessAttributes
-    NULL, // lpThreadAttributes
-    TRUE, // bInheritHandles
-    0, // dwCreationFlags
-    NULL, // lpEnvironment
-    workDir.c_str(), // lpCurrentDirectory
-    &startupInfo,
-    &processInfo);
-  assert(success);
-
-  WaitForSingleObject(processInfo.hProcess, INFINITE);
-  CloseHandle(processInfo.hThread);
-  CloseHandle(processInfo.hProcess);
-
-  CloseHandle(writePipe);
-  CloseHandle(readPipe);
-
-  readingThread.join();
-
-  return output;
-}
-
 std::regex part1Regex("(Part|Result) ?1: ?(.*)");
 std::regex part2Regex("(Part|Result) ?2: ?(.*)");
 
@@ -137,10 +68,78 @@ bool checkResult(int taskNr, const std::pair<std::string, std::optional<std::str
 
 
 
+/** Prints a table with the wall clock time and the resources consumed by each task
+ */
+void printResourceUsage(const std::vector<TaskRun>& runs) {
+  std::cout << "\n    wall[ms]   user[ms]    sys[ms]  peak RSS[MiB]  minor faults  major faults  vol. switches  invol. switches\n";
+  for (auto& run : runs) {
+    auto& usage = run.usage;
+    std::cout << std::setfill('0') << std::setw(2) << run.taskNr << ":" << std::setfill(' ') << std::fixed << std::setprecision(1)
+      << std::setw(9) << run.wallTime << std::setw(11) << usage.userTime << std::setw(11) << usage.systemTime
+      << std::setw(15) << usage.peakRss / 1024.0 << std::setw(14) << usage.minorFaults << std::setw(14) << usage.majorFaults
+      << std::setw(15) << usage.voluntarySwitches << std::setw(17) << usage.involuntarySwitches << (run.cached ? "  (cached)" : "") << "\n";
+  }
+}
+
+
+/** Parses the command line options:
+ *    -j, --jobs N        number of tasks to run concurrently
+ *    --bin-dir DIR       directory containing the task executables
+ *    --bench N           benchmark each task with N measured runs after checking the results
+ *    --warmup N          number of unmeasured runs before measuring (default 1)
+ *    --baseline FILE     benchmark baseline to compare against (written if it doesn't exist yet)
+ *    --threshold PCT     allowed regression of the median in percent (default 10)
+ *    --save-baseline     overwrite the baseline with the new measurements
+ *    --memory-limit [NN=]MIB   address space limit for task NN or all tasks (POSIX only)
+ *    --cpu-limit [NN=]SEC      CPU time limit for task NN or all tasks (POSIX only)
+ *    --force             run all tasks even if their executable and input didn't change since the cached run
+ */
+Options parseOptions(int argc, char* argv[]) {
+  // Parses "NN=VALUE" into limits[NN] or "VALUE" into limits[0]
+  auto parseLimit = [](std::string_view arg, std::map<int, size_t>& limits) {
+    auto separator = arg.find('=');
+    auto taskNr = (separator != std::string_view::npos) ? std::stoi(std::string(arg.substr(0, separator))) : 0;
+    limits[taskNr] = std::stoull(std::string(arg.substr(separator + 1))); // npos + 1 == 0
+  };
+
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+      options.jobs = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--bin-dir" && i + 1 < argc) {
+      options.binDir = argv[++i];
+    } else if (arg == "--bench" && i + 1 < argc) {
+      options.benchRuns = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--warmup" && i + 1 < argc) {
+      options.warmupRuns = std::max(0, std::stoi(argv[++i]));
+    } else if (arg == "--baseline" && i + 1 < argc) {
+      options.baselinePath = argv[++i];
+    } else if (arg == "--threshold" && i + 1 < argc) {
+      options.threshold = std::stod(argv[++i]);
+    } else if (arg == "--save-baseline") {
+      options.saveBaseline = true;
+    } else if (arg == "--force") {
+      options.force = true;
+    } else if (arg == "--memory-limit" && i + 1 < argc) {
+      parseLimit(argv[++i], options.memoryLimits);
+    } else if (arg == "--cpu-limit" && i + 1 < argc) {
+      parseLimit(argv[++i], options.cpuLimits);
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      std::exit(1);
+    }
+  }
+  return options;
+}
+
+
 // This project will check the results of all exercises (to validate correct it works correct after refactorings)
-int main()
+int main(int argc, char* argv[])
 {
-  for (auto line : stream::lines(std::ifstream("..\\data\\results.txt"))) {
+  auto options = parseOptions(argc, argv);
+
+  for (auto line : stream::lines(std::ifstream("../data/results.txt"))) {
     std::smatch match;
     std::regex_match(line, match, resultsRegex);
     if (match[1].matched) {
@@ -157,19 +156,70 @@ int main()
   }
 
 
+  // Run all tasks, which aren't commented out (possibly concurrently)
+  std::vector<int> taskNumbers;
+  for (int taskNr = 1; taskNr <= static_cast<int>(results.size()); ++taskNr) {
+    if (results[taskNr - 1]) {
+      taskNumbers.push_back(taskNr);
+    }
+  }
+
+  // Reuse the cached results of all tasks, whose executable and input didn't change (and which run without limits)
+  ResultCache cache((std::filesystem::path(options.binDir) / "check_all.cache").string());
+  std::vector<TaskRun> runs(taskNumbers.size());
+  std::vector<std::optional<CacheKey>> keys;
+  std::vector<int> uncachedTasks;
+  std::vector<size_t> uncachedIndices;
+  for (size_t i = 0; i < taskNumbers.size(); ++i) {
+    keys.push_back(cacheKey(taskNumbers[i], options));
+    if (keys[i] && !options.force) {
+      if (auto cached = cache.find(taskNumbers[i], *keys[i])) {
+        runs[i] = std::move(*cached);
+        continue;
+      }
+    }
+    uncachedTasks.push_back(taskNumbers[i]);
+    uncachedIndices.push_back(i);
+  }
+
+  auto uncachedRuns = runTasks(uncachedTasks, options);
+  for (size_t i = 0; i < uncachedRuns.size(); ++i) {
+    auto index = uncachedIndices[i];
+    runs[index] = std::move(uncachedRuns[i]);
+    if (keys[index] && runs[index].exitCode >= 0) { // don't cache tasks, which failed to start
+      cache.store(runs[index], *keys[index]);
+    }
+  }
+  cache.save();
+
+
+  // Report the results in task order
   int wrongTasks = 0;
   int taskNr = 0;
+  auto run = runs.begin();
   for (auto& expected : results) {
     ++taskNr;
-    if (expected) { // don't run commented out tasks
-      auto output = getTaskOutput(taskNr);
-      if (!checkResult(taskNr, *expected, output)) {
+    if (expected) {
+      if (run->exitCode != 0) {
+        std::cout << std::setfill('0') << std::setw(2) << taskNr << ": Exited with code " << run->exitCode << "\n";
+      }
+      if (!checkResult(taskNr, *expected, run->output)) {
         ++wrongTasks;
       }
+      ++run;
     } else {
       std::cout << std::setfill('0') << std::setw(2) << taskNr << ": skipped\n";
     }
   }
 
-  std::cout << "\n\n" << wrongTasks << " Errors!";
+  printResourceUsage(runs);
+
+  std::cout << "\n\n" << wrongTasks << " Errors!\n";
+
+  int regressions = 0;
+  if (options.benchRuns > 0) {
+    regressions = runBenchmark(taskNumbers, options);
+  }
+
+  return (wrongTasks || regressions) ? 1 : 0;
 }
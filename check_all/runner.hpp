@@ -0,0 +1,80 @@
+#pragma once
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include <thread>
+
+#ifdef _DEBUG
+#define CONFIG "Debug"
+#else
+#define CONFIG "Release"
+#endif
+
+/** Command line options of check_all
+ */
+struct Options {
+  int jobs = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); // maximum number of concurrently running tasks
+#ifdef _WIN32
+  std::string binDir = "..\\x64\\" CONFIG; // directory containing the task executables
+#else
+  std::string binDir = "../build";
+#endif
+
+  // Benchmark mode
+  int benchRuns = 0; // number of measured runs per task (0 = no benchmark)
+  int warmupRuns = 1; // number of unmeasured runs per task before measuring
+  double threshold = 10.0; // allowed regression of the median against the baseline in percent
+  std::string baselinePath = "../data/benchmark.txt";
+  bool saveBaseline = false; // overwrite an existing baseline with the new results
+
+  bool force = false; // run all tasks even if a cached result exists
+
+  // Resource limits per task number (0 = limit for all tasks without an own entry)
+  std::map<int, size_t> memoryLimits; // address space in MiB
+  std::map<int, size_t> cpuLimits; // CPU time in seconds
+
+  // Returns the limit for the given task or 0 if it is unlimited
+  static size_t limitFor(const std::map<int, size_t>& limits, int taskNr) {
+    if (auto pos = limits.find(taskNr); pos != limits.end()) {
+      return pos->second;
+    }
+    auto pos = limits.find(0);
+    return (pos != limits.end()) ? pos->second : 0;
+  }
+};
+
+
+/** Resources consumed by a task (all zero if the platform doesn't report them)
+ */
+struct ResourceUsage {
+  double userTime = 0; // CPU time in milliseconds
+  double systemTime = 0;
+  size_t peakRss = 0; // peak resident set size in KiB
+  long minorFaults = 0; // page faults served without I/O (Windows reports all page faults here)
+  long majorFaults = 0; // page faults requiring I/O
+  long voluntarySwitches = 0; // context switches because the task blocked
+  long involuntarySwitches = 0; // context switches because the task was preempted
+};
+
+
+/** Output and exit code of one task execution
+ */
+struct TaskRun {
+  int taskNr = 0;
+  std::string output;
+  int exitCode = 0;
+  double wallTime = 0; // milliseconds from start to exit
+  ResourceUsage usage;
+  bool cached = false; // result was taken from the result cache instead of running the task
+};
+
+
+// Returns the path of the task's executable
+std::string taskExecutable(int taskNr, const Options& options);
+
+
+/** Runs the given tasks and returns their results in the same order as the passed task numbers.
+ *  Each task is executed with "../NN/" as working directory.
+ */
+std::vector<TaskRun> runTasks(const std::vector<int>& taskNumbers, const Options& options);
@@ -0,0 +1,220 @@
+#ifndef _WIN32
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+
+#include "runner.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+
+/** A spawned task, whose output is still being collected
+ */
+struct RunningTask {
+  size_t index; // index into the result vector
+  pid_t pid;
+  int readFd; // read end of the child's stdout/stderr pipe
+  std::chrono::steady_clock::time_point startTime;
+};
+
+
+std::string taskExecutable(int taskNr, const Options& options) {
+  return (std::filesystem::path(options.binDir) / std::format("{:02d}", taskNr)).string();
+}
+
+
+/** Starts the task with its stdout and stderr redirected into a pipe. 
+ *  Returns false and stores the error in run.output if the task couldn't be started.
+ */
+bool spawnTask(TaskRun& run, const Options& options, RunningTask& running) {
+  std::string taskId = std::format("{:02d}", run.taskNr);
+  // The executable path must be absolute, because it is resolved after changing into the working directory
+  auto exePath = std::filesystem::absolute(taskExecutable(run.taskNr, options)).string();
+  auto workDir = "../" + taskId + "/";
+
+  int pipeFds[2];
+  if (pipe(pipeFds) != 0) {
+    run.output = std::format("Failed to create pipe: {}", std::strerror(errno));
+    run.exitCode = -1;
+    return false;
+  }
+  // Don't leak our pipe ends into concurrently spawned children, otherwise we wouldn't see EOF until all of them exit
+  fcntl(pipeFds[0], F_SETFD, FD_CLOEXEC);
+  fcntl(pipeFds[1], F_SETFD, FD_CLOEXEC);
+
+  char* argv[] = { exePath.data(), nullptr };
+  running.startTime = std::chrono::steady_clock::now();
+
+  int error = 0;
+  auto memoryLimit = Options::limitFor(options.memoryLimits, run.taskNr);
+  auto cpuLimit = Options::limitFor(options.cpuLimits, run.taskNr);
+  if (memoryLimit || cpuLimit) {
+    // posix_spawn cannot set resource limits for the child -> fall back to fork() + setrlimit() + exec()
+    // The child reports a failing chdir() or execv() through the error pipe, which a successful execv() closes empty
+    int errorFds[2];
+    if (pipe(errorFds) != 0) {
+      close(pipeFds[0]);
+      close(pipeFds[1]);
+      run.output = std::format("Failed to create pipe: {}", std::strerror(errno));
+      run.exitCode = -1;
+      return false;
+    }
+    fcntl(errorFds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(errorFds[1], F_SETFD, FD_CLOEXEC);
+
+    running.pid = fork();
+    if (running.pid == 0) {
+      int nullFd = open("/dev/null", O_RDONLY);
+      dup2(nullFd, STDIN_FILENO);
+      dup2(pipeFds[1], STDOUT_FILENO);
+      dup2(pipeFds[1], STDERR_FILENO);
+      if (memoryLimit) {
+        rlimit limit { .rlim_cur = memoryLimit << 20, .rlim_max = memoryLimit << 20 };
+        setrlimit(RLIMIT_AS, &limit);
+      }
+      if (cpuLimit) {
+        rlimit limit { .rlim_cur = cpuLimit, .rlim_max = cpuLimit + 1 }; // SIGXCPU at the soft limit, SIGKILL at the hard limit
+        setrlimit(RLIMIT_CPU, &limit);
+      }
+      if (chdir(workDir.c_str()) == 0) {
+        execv(exePath.c_str(), argv);
+      }
+      int childError = errno;
+      [[maybe_unused]] auto written = write(errorFds[1], &childError, sizeof(childError));
+      _exit(127); // only async-signal-safe calls after fork()
+    }
+
+    error = (running.pid < 0) ? errno : 0;
+    close(errorFds[1]);
+    if (running.pid > 0) {
+      int childError = 0;
+      ssize_t bytesRead;
+      while ((bytesRead = read(errorFds[0], &childError, sizeof(childError))) < 0 && errno == EINTR) {}
+      if (bytesRead == sizeof(childError)) {
+        error = childError;
+        while (waitpid(running.pid, nullptr, 0) < 0 && errno == EINTR) {} // reap the failed child
+      }
+    }
+    close(errorFds[0]);
+  } else {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, pipeFds[1], STDERR_FILENO);
+    posix_spawn_file_actions_addchdir_np(&actions, workDir.c_str());
+
+    error = posix_spawn(&running.pid, exePath.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+  }
+  close(pipeFds[1]); // only the child writes into the pipe
+
+  if (error) {
+    close(pipeFds[0]);
+    run.output = std::format("Failed to spawn {}: {}", exePath, std::strerror(error));
+    run.exitCode = -1;
+    return false;
+  }
+
+  running.readFd = pipeFds[0];
+  return true;
+}
+
+
+/** Reaps the task after its output pipe has been closed and records the exit code and resource usage
+ */
+void finishTask(TaskRun& run, const RunningTask& running) {
+  close(running.readFd);
+
+  int status = 0;
+  rusage usage = {};
+  while (wait4(running.pid, &status, 0, &usage) < 0 && errno == EINTR) {}
+  run.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - running.startTime).count();
+  if (WIFEXITED(status)) {
+    run.exitCode = WEXITSTATUS(status);
+  } else if (WIFSIGNALED(status)) {
+    run.exitCode = 128 + WTERMSIG(status); // like the shell reports it
+  }
+
+  auto milliseconds = [](const timeval& time) { return time.tv_sec * 1e3 + time.tv_usec / 1e3; };
+  run.usage = ResourceUsage {
+    .userTime = milliseconds(usage.ru_utime),
+    .systemTime = milliseconds(usage.ru_stime),
+#ifdef __APPLE__
+    .peakRss = static_cast<size_t>(usage.ru_maxrss) / 1024, // reported in bytes instead of KiB
+#else
+    .peakRss = static_cast<size_t>(usage.ru_maxrss),
+#endif
+    .minorFaults = usage.ru_minflt,
+    .majorFaults = usage.ru_majflt,
+    .voluntarySwitches = usage.ru_nvcsw,
+    .involuntarySwitches = usage.ru_nivcsw
+  };
+}
+
+
+std::vector<TaskRun> runTasks(const std::vector<int>& taskNumbers, const Options& options) {
+  std::vector<TaskRun> runs(taskNumbers.size());
+  std::vector<RunningTask> running;
+  std::vector<pollfd> pollFds;
+
+  size_t next = 0;
+  while (next < taskNumbers.size() || !running.empty()) {
+    // Fill up the free job slots
+    while (next < taskNumbers.size() && static_cast<int>(running.size()) < options.jobs) {
+      auto& run = runs[next];
+      run.taskNr = taskNumbers[next];
+      RunningTask task { .index = next++ };
+      if (spawnTask(run, options, task)) {
+        running.push_back(task);
+      }
+    }
+
+    if (running.empty()) {
+      continue;
+    }
+
+    // Wait until any of the running tasks has output for us (or closed its pipe)
+    pollFds.clear();
+    for (auto& task : running) {
+      pollFds.push_back({ .fd = task.readFd, .events = POLLIN });
+    }
+    if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(std::format("poll() failed: {}", std::strerror(errno)));
+    }
+
+    // Iterate backwards to erase finished tasks without skipping any entries
+    for (size_t i = running.size(); i-- > 0;) {
+      if (!pollFds[i].revents) {
+        continue;
+      }
+
+      auto& run = runs[running[i].index];
+      char buf[4096];
+      auto bytesRead = read(running[i].readFd, buf, sizeof(buf));
+      if (bytesRead > 0) {
+        run.output.append(buf, bytesRead);
+      } else if (bytesRead == 0 || errno != EINTR) {
+        // EOF -> the task has exited (or at least closed its output)
+        finishTask(run, running[i]);
+        running.erase(running.begin() + i);
+      }
+    }
+  }
+
+  return runs;
+}
+
+#endif
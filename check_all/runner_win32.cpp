@@ -0,0 +1,117 @@
+#ifdef _WIN32
+#include <cassert>
+#include <chrono>
+#include <format>
+#include <iostream>
+
+#include "runner.hpp"
+
+#include <windows.h>
+#include <psapi.h>
+
+
+std::string taskExecutable(int taskNr, const Options& options) {
+  return options.binDir + "\\" + std::format("{:02d}", taskNr) + ".exe";
+}
+
+
+TaskRun runTask(int taskNumber, const Options& options) {
+  SECURITY_ATTRIBUTES pipeSecurityAttributes = {
+    .nLength = sizeof(SECURITY_ATTRIBUTES),
+    .bInheritHandle = TRUE 
+  };
+  HANDLE readPipe, writePipe;
+  BOOL success = CreatePipe(
+    &readPipe, // hReadPipe
+    &writePipe, // hWritePipe
+    &pipeSecurityAttributes, // lpPipeAttributes
+    0); // nSize (0 means default)
+  assert(success);
+
+  TaskRun run { .taskNr = taskNumber };
+
+  auto readingThreadFunc = [readPipe, &run]() {
+    char buf[256];
+    for (;;) {
+      DWORD bytesRead;
+      BOOL ok = ReadFile(readPipe, buf, sizeof(buf), &bytesRead, NULL);
+      if (ok) {
+        run.output.append(buf, bytesRead);
+      } else {
+        return;
+      }
+    }
+  };
+  std::thread readingThread { readingThreadFunc };
+
+  STARTUPINFOA startupInfo = {
+      .cb = sizeof(STARTUPINFOA),
+      .dwFlags = STARTF_USESTDHANDLES,
+      .hStdInput = INVALID_HANDLE_VALUE,
+      .hStdOutput = writePipe,
+      .hStdError = writePipe
+  };
+  PROCESS_INFORMATION processInfo = {};
+
+  std::string taskId = std::format("{:02d}", taskNumber);
+  auto exePath = taskExecutable(taskNumber, options);
+  auto workDir = "..\\" + taskId + "\\";
+
+  auto startTime = std::chrono::steady_clock::now();
+  success = CreateProcessA(
+    exePath.c_str(), // lpApplicationName
+    NULL, // lpCommandLine
+    NULL, // lpProcessAttributes
+    NULL, // lpThreadAttributes
+    TRUE, // bInheritHandles
+    0, // dwCreationFlags
+    NULL, // lpEnvironment
+    workDir.c_str(), // lpCurrentDirectory
+    &startupInfo,
+    &processInfo);
+  assert(success);
+
+  WaitForSingleObject(processInfo.hProcess, INFINITE);
+  run.wallTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+  DWORD exitCode = 0;
+  GetExitCodeProcess(processInfo.hProcess, &exitCode);
+  run.exitCode = static_cast<int>(exitCode);
+
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (GetProcessTimes(processInfo.hProcess, &creationTime, &exitTime, &kernelTime, &userTime)) {
+    auto milliseconds = [](const FILETIME& time) { return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 1e4; }; // 100ns units
+    run.usage.userTime = milliseconds(userTime);
+    run.usage.systemTime = milliseconds(kernelTime);
+  }
+  PROCESS_MEMORY_COUNTERS memoryCounters = {};
+  if (GetProcessMemoryInfo(processInfo.hProcess, &memoryCounters, sizeof(memoryCounters))) {
+    run.usage.peakRss = memoryCounters.PeakWorkingSetSize / 1024;
+    run.usage.minorFaults = memoryCounters.PageFaultCount;
+  }
+  CloseHandle(processInfo.hThread);
+  CloseHandle(processInfo.hProcess);
+
+  CloseHandle(writePipe);
+  CloseHandle(readPipe);
+
+  readingThread.join();
+
+  return run;
+}
+
+
+std::vector<TaskRun> runTasks(const std::vector<int>& taskNumbers, const Options& options) {
+  if (!options.memoryLimits.empty() || !options.cpuLimits.empty()) {
+    std::cerr << "Resource limits are not supported on Windows and will be ignored\n";
+  }
+
+  // The tasks are run one after another, because all children inherit all inheritable pipe handles, which 
+  // would keep the pipes of concurrently started tasks open.
+  std::vector<TaskRun> runs;
+  for (auto taskNr : taskNumbers) {
+    runs.push_back(runTask(taskNr, options));
+  }
+  return runs;
+}
+
+#endif
@@ -0,0 +1,143 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <shared/mapped_file.hpp>
+#include <shared/solver.hpp>
+#include <shared/timing.hpp>
+#include <shared/allocation_hooks.hpp>
+
+#include "service.hpp"
+
+// All days are compiled into this executable with AOC_DRIVER defined, which removes their main() functions 
+// and leaves only their solver registrations.
+
+struct Options {
+  int repeat = 1; // number of timed solve() calls per day
+  std::string dataDir = "../data"; // contains the inputs as NN/input.txt
+  std::vector<int> days; // days to run (all registered days if empty)
+};
+
+
+/** Parses the command line:
+ *    driver [--repeat N] [--data DIR] [day...]
+ *  The service modes are handled before (see main()).
+ */
+Options parseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--repeat" && i + 1 < argc) {
+      options.repeat = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--data" && i + 1 < argc) {
+      options.dataDir = argv[++i];
+    } else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) {
+      options.days.push_back(std::stoi(std::string(arg)));
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      std::exit(1);
+    }
+  }
+
+  if (options.days.empty()) {
+    for (auto& [day, factory] : solver::registry()) {
+      options.days.push_back(day);
+    }
+  }
+  return options;
+}
+
+
+// Maps the given file into memory or returns nullptr if it cannot be mapped
+std::unique_ptr<MappedFile> mapFile(const std::filesystem::path& path) {
+  try {
+    return std::make_unique<MappedFile>(path.string());
+  } catch (const std::runtime_error&) {
+    return nullptr;
+  }
+}
+
+
+// Returns the milliseconds it takes to call func()
+template<typename Func>
+double measure(Func&& func) {
+  auto start = std::chrono::steady_clock::now();
+  func();
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+// The solver service (see service.hpp):
+//   driver --serve SOCKET
+//   driver --client SOCKET (DAY PATH | DAY - | stop)
+int serviceMain(int argc, char* argv[]) {
+  try {
+    if (std::string_view(argv[1]) == "--serve") {
+      return service::serve(argv[2]);
+    }
+    return service::request(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+}
+
+
+int main(int argc, char* argv[]) {
+  if (argc > 2 && (std::string_view(argv[1]) == "--serve" || std::string_view(argv[1]) == "--client")) {
+    return serviceMain(argc, argv);
+  }
+
+  auto options = parseOptions(argc, argv);
+
+  int errors = 0;
+  double totalTime = 0;
+  for (auto day : options.days) {
+    auto solver = solver::create(day);
+    auto path = std::filesystem::path(options.dataDir) / std::format("{:02d}", day) / "input.txt";
+    auto input = mapFile(path);
+    if (!solver || !input) {
+      std::cout << std::format("{:02d}: {}\n", day, solver ? "Failed to read " + path.string() : "No solver registered");
+      ++errors;
+      continue;
+    }
+
+    timing::Scope dayTimer(std::format("day {:02d}", day));
+    auto parseTime = measure([&] {
+      timing::Scope timer("parse");
+      solver->parse(input->view());
+    });
+
+    // The solve time is the fastest of all repetitions
+    Answer answer;
+    auto solveTime = std::numeric_limits<double>::max();
+    for (int i = 0; i < options.repeat; ++i) {
+      solveTime = std::min(solveTime, measure([&] {
+        timing::Scope timer("solve");
+        answer = solver->solve();
+      }));
+    }
+
+    // The parse cost per line makes changes to the line parsing comparable between inputs of different length
+    auto text = input->view();
+    auto lines = std::ranges::count(text, '\n') + (!text.empty() && text.back() != '\n');
+    auto nsPerLine = lines ? parseTime * 1e6 / lines : 0.0;
+
+    totalTime += parseTime + solveTime;
+    std::cout << std::format("{:02d}: Part 1: {:<16} Part 2: {:<16} parse {:9.3f}ms ({:8.1f}ns/line)  solve {:9.3f}ms\n", 
+      day, answer.part1, answer.part2, parseTime, nsPerLine, solveTime);
+  }
+
+  std::cout << std::format("\nTotal: {:.3f}ms\n", totalTime);
+  timing::report(std::cout);
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,477 @@
+#ifdef _WIN32
+// winsock2.h includes windows.h, whose min and max macros would break std::min() and std::max() in the headers below
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h> // before windows.h, which mapped_file.hpp includes
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <spanstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <shared/mapped_file.hpp>
+#include <shared/snapshot.hpp>
+#include <shared/solver.hpp>
+
+#include "service.hpp"
+
+namespace service {
+
+namespace {
+
+#ifdef _WIN32
+using Socket = SOCKET;
+constexpr Socket InvalidSocket = INVALID_SOCKET;
+constexpr int ShutdownBoth = SD_BOTH;
+void closeSocket(Socket socket) { closesocket(socket); }
+#else
+using Socket = int;
+constexpr Socket InvalidSocket = -1;
+constexpr int ShutdownBoth = SHUT_RDWR;
+void closeSocket(Socket socket) { close(socket); }
+#endif
+
+constexpr int IdleTimeoutSeconds = 30;        // a connection without any data for this long is closed
+constexpr size_t MaxPayloadSize = size_t(1) << 30; // of inline inputs
+constexpr size_t MaxConnections = 64;         // served at the same time, each on its own thread
+
+#ifdef MSG_NOSIGNAL
+constexpr int SendFlags = MSG_NOSIGNAL; // a client closing early must not kill the server with SIGPIPE
+#else
+constexpr int SendFlags = 0;
+#endif
+
+
+// Initializes the socket library for the lifetime of the object (only needed on Windows)
+struct SocketLibrary {
+#ifdef _WIN32
+  SocketLibrary() {
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+      throw std::runtime_error("Failed to initialize Winsock");
+    }
+  }
+  ~SocketLibrary() { WSACleanup(); }
+#endif
+};
+
+
+sockaddr_un socketAddress(const std::string& path) {
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Socket path too long: " + path);
+  }
+  std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+  return address;
+}
+
+
+// Removes the socket file at the path. Anything else at the path (e.g. a mistyped path to a file) is left alone.
+void removeSocket(const std::string& path) {
+#ifdef _WIN32
+  WIN32_FIND_DATAA data;
+  auto find = FindFirstFileA(path.c_str(), &data);
+  if (find == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  FindClose(find);
+  bool isSocket = (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) && data.dwReserved0 == IO_REPARSE_TAG_AF_UNIX;
+#else
+  struct stat status;
+  bool isSocket = lstat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode);
+#endif
+  if (isSocket) {
+    std::remove(path.c_str());
+  }
+}
+
+
+// Makes blocking receives and sends on the socket fail after the idle timeout
+void setTimeouts(Socket socket) {
+#ifdef _WIN32
+  DWORD timeout = IdleTimeoutSeconds * 1000;
+#else
+  timeval timeout { .tv_sec = IdleTimeoutSeconds, .tv_usec = 0 };
+#endif
+  setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+  setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+
+/** Buffered line and block reads and writes on a connected socket, which it closes
+ */
+class Connection {
+public:
+  explicit Connection(Socket socket) : socket(socket) {}
+  Connection(const Connection&) = delete;
+  Connection& operator=(const Connection&) = delete;
+  ~Connection() { closeSocket(socket); }
+
+  // The next line without the '\n' or nullopt if the peer closed the connection
+  std::optional<std::string> readLine() {
+    size_t end;
+    while ((end = buffer.find('\n')) == std::string::npos) {
+      if (!receive()) {
+        return std::nullopt;
+      }
+    }
+    auto line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return line;
+  }
+
+  // Exactly size bytes, throws std::runtime_error if the connection ends before
+  std::string read(size_t size) {
+    while (buffer.size() < size) {
+      if (!receive()) {
+        throw std::runtime_error("Connection closed within the payload");
+      }
+    }
+    auto data = buffer.substr(0, size);
+    buffer.erase(0, size);
+    return data;
+  }
+
+  void write(std::string_view data) {
+    while (!data.empty()) {
+      auto sent = send(socket, data.data(), static_cast<int>(data.size()), SendFlags);
+      if (sent <= 0) {
+        throw std::runtime_error("Failed to send");
+      }
+      data.remove_prefix(static_cast<size_t>(sent));
+    }
+  }
+
+private:
+  bool receive() {
+    char chunk[1 << 16];
+    auto received = recv(socket, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      return false;
+    }
+    buffer.append(chunk, static_cast<size_t>(received));
+    return true;
+  }
+
+  Socket socket;
+  std::string buffer; // received, but not yet read
+};
+
+
+struct Result {
+  Answer answer;
+  double parseTime = 0; // milliseconds, 0 for a cache hit
+  double solveTime = 0;
+  bool cached = false;
+};
+
+
+/** Parsed solvers by day and input checksum. Each entry owns a copy of its input, which the solver may refer to.
+ *  The least recently used entry is evicted when the cache is full. solve() may be called from any thread, the 
+ *  requests are solved one after the other.
+ */
+class SolverCache {
+public:
+  explicit SolverCache(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {}
+
+  Result solve(int day, std::string_view input) {
+    std::lock_guard lock(mutex);
+    Result result;
+    auto key = std::make_pair(day, snapshot::checksum(input));
+    auto pos = entries.find(key);
+    if (pos != entries.end() && pos->second.input == input) {
+      result.cached = true;
+    } else {
+      auto solver = solver::create(day);
+      if (!solver) {
+        throw std::runtime_error(std::format("No solver registered for day {}", day));
+      }
+      if (entries.size() >= capacity && pos == entries.end()) {
+        evict();
+      }
+      auto& entry = entries[key];
+      entry.input = input; // the copy, which the solver parses
+      entry.solver.reset(); // of another input with the same checksum
+      try {
+        result.parseTime = measure([&] { solver->parse(entry.input); });
+      } catch (...) {
+        entries.erase(key); // never keep an entry without a parsed solver
+        throw;
+      }
+      entry.solver = std::move(solver);
+      pos = entries.find(key);
+    }
+
+    pos->second.lastUse = ++uses;
+    result.solveTime = measure([&] { result.answer = pos->second.solver->solve(); });
+    return result;
+  }
+
+private:
+  struct Entry {
+    std::string input;
+    std::unique_ptr<Solver> solver; // parsed from input
+    uint64_t lastUse = 0;
+  };
+
+  template<typename Func>
+  static double measure(Func&& func) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void evict() {
+    auto oldest = std::ranges::min_element(entries, {}, [](auto& entry) { return entry.second.lastUse; });
+    entries.erase(oldest);
+  }
+
+  std::mutex mutex;
+  size_t capacity;
+  uint64_t uses = 0;
+  std::map<std::pair<int, uint64_t>, Entry> entries;
+};
+
+
+// An error after which the following data of the connection cannot be interpreted, so the connection is closed
+struct ProtocolError : std::runtime_error {
+  using std::runtime_error::runtime_error;
+};
+
+
+/** Handles one request line (and reads its payload), returns the response line or nullopt to stop the server.
+ *  Throws ProtocolError if the payload of an inline request cannot be skipped, after other exceptions the connection
+ *  can be used for the next request.
+ */
+std::optional<std::string> handle(std::string_view line, Connection& connection, SolverCache& cache) {
+  std::ispanstream request(line);
+  std::string command, dayText, source;
+  request >> command >> dayText >> source;
+  if (command == "stop") {
+    return std::nullopt;
+  }
+
+  // The payload is read before the rest of the request is checked, otherwise the payload of an invalid request 
+  // would be read as the next request lines
+  std::string payload;
+  if (source == "inline") {
+    size_t size = 0;
+    if (!(request >> size)) {
+      throw ProtocolError("Missing payload size");
+    }
+    if (size > MaxPayloadSize) {
+      throw ProtocolError(std::format("Payload larger than {} bytes", MaxPayloadSize));
+    }
+    payload = connection.read(size);
+  }
+
+  int day = 0;
+  auto dayEnd = dayText.data() + dayText.size();
+  auto [end, error] = std::from_chars(dayText.data(), dayEnd, day);
+  if (command != "solve" || error != std::errc() || end != dayEnd || (source != "file" && source != "inline")) {
+    throw std::runtime_error("Unknown request: " + std::string(line));
+  }
+
+  Result result;
+  if (source == "inline") {
+    result = cache.solve(day, payload);
+  } else {
+    std::string path;
+    std::getline(request >> std::ws, path); // the rest of the line, so paths may contain spaces
+    MappedFile input(path);
+    result = cache.solve(day, input.view());
+  }
+
+  return std::format("ok {} {} parse={:.3f}ms solve={:.3f}ms cache={}", result.answer.part1, result.answer.part2,
+    result.parseTime, result.solveTime, result.cached ? "hit" : "miss");
+}
+
+/** The state of a running server, which its connection threads share
+ */
+struct Server {
+  explicit Server(size_t cacheSize) : cache(cacheSize) {}
+
+  SolverCache cache;
+  std::atomic<bool> stopping = false;
+
+  std::mutex mutex; // for the members below
+  std::condition_variable finished;
+  std::set<Socket> connections; // open ones
+  size_t threads = 0;           // running connection threads
+};
+
+
+// Serves the requests of one client until it disconnects, stays idle for too long or stops the server
+void serveConnection(Connection& connection, Server& server) {
+  try {
+    while (auto line = connection.readLine()) {
+      std::string response;
+      try {
+        auto result = handle(*line, connection, server.cache);
+        if (!result) {
+          server.stopping = true;
+          connection.write("ok stopping\n");
+          break;
+        }
+        response = *result;
+      } catch (const ProtocolError& e) {
+        connection.write(std::string("error ") + e.what() + "\n");
+        break;
+      } catch (const std::exception& e) {
+        response = std::string("error ") + e.what();
+      }
+      connection.write(response + "\n");
+    }
+  } catch (const std::runtime_error&) {
+    // the client went away or timed out
+  }
+}
+
+
+// Wakes up the server's accept() by connecting to it, so it notices that it is stopping
+void wakeUp(const sockaddr_un& address) {
+  auto socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket != InvalidSocket) {
+    connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    closeSocket(socket);
+  }
+}
+
+}
+
+
+int serve(const std::string& socketPath, size_t cacheSize) {
+  SocketLibrary library;
+  auto address = socketAddress(socketPath);
+  auto listener = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener == InvalidSocket) {
+    throw std::runtime_error("Failed to create a socket");
+  }
+  removeSocket(socketPath); // left over by a server, which didn't stop cleanly
+  if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 16) != 0) {
+    closeSocket(listener);
+    throw std::runtime_error("Failed to listen on " + socketPath);
+  }
+  std::cerr << "Listening on " << socketPath << "\n";
+
+  // Each connection is served on its own thread, so an idle or slow client doesn't block the others
+  Server server(cacheSize);
+  while (!server.stopping) {
+    auto client = accept(listener, nullptr, nullptr);
+    if (client == InvalidSocket) {
+      continue;
+    }
+    if (server.stopping) {
+      closeSocket(client); // the wake up connection
+      break;
+    }
+
+    setTimeouts(client);
+    std::unique_lock lock(server.mutex);
+    if (server.connections.size() >= MaxConnections) {
+      lock.unlock();
+      Connection(client).write("error Too many connections\n");
+      continue;
+    }
+    server.connections.insert(client);
+    ++server.threads;
+    std::thread([client, &server, address] {
+      {
+        Connection connection(client);
+        serveConnection(connection, server);
+        std::lock_guard lock(server.mutex);
+        server.connections.erase(client); // before the socket is closed, its handle may be reused right after
+      }
+      if (server.stopping) {
+        wakeUp(address);
+      }
+      std::lock_guard lock(server.mutex);
+      --server.threads;
+      server.finished.notify_all();
+    }).detach();
+  }
+
+  // End the remaining connections and wait for their threads, which refer to the server
+  {
+    std::unique_lock lock(server.mutex);
+    for (auto client : server.connections) {
+      shutdown(client, ShutdownBoth);
+    }
+    server.finished.wait(lock, [&] { return server.threads == 0; });
+  }
+
+  closeSocket(listener);
+  removeSocket(socketPath);
+  return 0;
+}
+
+
+int request(const std::string& socketPath, const std::vector<std::string>& arguments) {
+  std::string message;
+  if (arguments.size() == 1 && arguments[0] == "stop") {
+    message = "stop\n";
+  } else if (arguments.size() == 2 && arguments[1] == "-") {
+    std::string input(std::istreambuf_iterator<char>(std::cin), std::istreambuf_iterator<char>());
+    message = std::format("solve {} inline {}\n", std::stoi(arguments[0]), input.size()) + input;
+  } else if (arguments.size() == 2) {
+    // The server may run in another directory
+    message = std::format("solve {} file {}\n", std::stoi(arguments[0]), std::filesystem::absolute(arguments[1]).string());
+  } else {
+    std::cerr << "Usage: driver --client SOCKET (DAY PATH | DAY - | stop)\n";
+    return 1;
+  }
+
+  SocketLibrary library;
+  auto address = socketAddress(socketPath);
+  auto socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socket == InvalidSocket) {
+    throw std::runtime_error("Failed to create a socket");
+  }
+  Connection connection(socket);
+  if (connect(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+    throw std::runtime_error("Failed to connect to " + socketPath);
+  }
+
+  connection.write(message);
+  auto response = connection.readLine();
+  if (!response) {
+    throw std::runtime_error("No response from " + socketPath);
+  }
+  std::cout << *response << "\n";
+  return response->starts_with("ok") ? 0 : 1;
+}
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <vector>
+
+/** Long running solver service on a local Unix domain socket, so that tools calling the solvers many times don't pay
+ *  the process startup and the parsing of unchanged inputs on every call:
+ *
+ *    driver --serve /tmp/aoc.sock &
+ *    driver --client /tmp/aoc.sock 5 ../data/05/input.txt   // the server reads the file
+ *    driver --client /tmp/aoc.sock 5 - < input.txt          // the input is sent inline
+ *    driver --client /tmp/aoc.sock stop
+ *
+ *  The protocol consists of text lines, a connection may send any number of requests:
+ *
+ *    solve DAY file PATH\n              ->  ok PART1 PART2 parse=MS solve=MS cache=hit|miss\n
+ *    solve DAY inline SIZE\n<SIZE bytes>     or error MESSAGE\n
+ *    stop\n                             ->  ok stopping\n
+ *
+ *  The parsed solvers of the most recently used inputs are kept per day and input checksum, so a repeated request
+ *  for the same input only calls solve(). Each connection is served on its own thread (at most 64 at a time), but
+ *  the requests are solved one after the other. A connection without any data for 30 seconds is closed, inline 
+ *  inputs are limited to 1 GiB.
+ */
+namespace service {
+
+// Serves requests until a stop request, returns the exit code
+int serve(const std::string& socketPath, size_t cacheSize = 16);
+
+// Sends one request built from the arguments (DAY PATH, DAY - for stdin or stop) and prints the response line
+int request(const std::string& socketPath, const std::vector<std::string>& arguments);
+
+}
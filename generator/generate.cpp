@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generate.hpp"
+
+namespace generate {
+
+namespace {
+
+/** splitmix64 based random numbers. The standard distributions are implementation defined, so they would break
+ *  the reproducibility between compilers.
+ */
+struct Random {
+  Random(uint64_t seed) : state(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+  // Uniform in [0; n)
+  uint64_t below(uint64_t n) { return next() % n; }
+
+  // Uniform in [min; max]
+  int64_t between(int64_t min, int64_t max) { return min + static_cast<int64_t>(below(static_cast<uint64_t>(max - min + 1))); }
+
+  bool chance(double probability) { return (next() >> 11) * 0x1.0p-53 < probability; }
+
+  template<typename T>
+  const T& pick(const std::vector<T>& values) { return values[below(values.size())]; }
+
+  template<typename T>
+  void shuffle(std::vector<T>& values) {
+    for (size_t i = values.size(); i > 1; --i) {
+      std::swap(values[i - 1], values[below(i)]);
+    }
+  }
+
+  uint64_t state;
+};
+
+
+/** Collects the generated text and passes it to the sink whenever 1 MiB have been collected
+ */
+struct Output {
+  Output(const Sink& sink) : sink(sink) {
+    buffer.reserve(1 << 20);
+  }
+
+  Output& operator<<(std::string_view text) {
+    buffer += text;
+    if (buffer.size() >= (1 << 20)) {
+      flush();
+    }
+    return *this;
+  }
+
+  Output& operator<<(char ch) { return *this << std::string_view(&ch, 1); }
+  Output& operator<<(int64_t value) { return *this << std::string_view(std::to_string(value)); }
+
+  void flush() {
+    if (!buffer.empty()) {
+      sink(buffer);
+      buffer.clear();
+    }
+  }
+
+  const Sink& sink;
+  std::string buffer;
+};
+
+
+// 01: SIZE calibration lines, each with at least one digit and some spelled out digits
+void generate01(int64_t size, Random& random, Output& out) {
+  const std::vector<std::string_view> digitNames = { "one", "two", "three", "four", "five", "six", "seven", "eight", "nine" };
+  for (int64_t line = 0; line < size; ++line) {
+    std::string text;
+    auto parts = random.between(2, 8);
+    auto digitPart = random.below(parts); // guarantees at least one digit
+    for (int64_t part = 0; part < parts; ++part) {
+      if (part == static_cast<int64_t>(digitPart) || random.chance(0.3)) {
+        text += static_cast<char>('1' + random.below(9));
+      } else if (random.chance(0.4)) {
+        text += random.pick(digitNames);
+      } else {
+        for (auto letters = random.between(1, 5); letters > 0; --letters) {
+          text += static_cast<char>('a' + random.below(26));
+        }
+      }
+    }
+    out << text << '\n';
+  }
+}
+
+
+// 02: SIZE games with 1-6 draws of up to 20 cubes per color
+void generate02(int64_t size, Random& random, Output& out) {
+  const std::vector<std::string_view> colors = { "red", "green", "blue" };
+  for (int64_t game = 1; game <= size; ++game) {
+    out << "Game " << game << ": ";
+    for (auto draws = random.between(1, 6); draws > 0; --draws) {
+      auto drawColors = colors;
+      random.shuffle(drawColors);
+      drawColors.resize(random.between(1, 3));
+      for (size_t i = 0; i < drawColors.size(); ++i) {
+        out << random.between(1, 20) << ' ' << drawColors[i] << (i + 1 < drawColors.size() ? ", " : "");
+      }
+      out << (draws > 1 ? "; " : "");
+    }
+    out << '\n';
+  }
+}
+
+
+// 03: SIZE x SIZE engine schematic with numbers of 1-3 digits and symbols (a fifth of them gears)
+void generate03(int64_t size, Random& random, Output& out) {
+  const std::string_view symbols = "*#+$/@%=&-";
+  std::string row;
+  for (int64_t y = 0; y < size; ++y) {
+    row.assign(size, '.');
+    for (int64_t x = 0; x < size; ++x) {
+      if (random.chance(0.12)) {
+        auto digits = std::min<int64_t>(random.between(1, 3), size - x);
+        row[x] = static_cast<char>('1' + random.below(9)); // no leading zeros
+        for (int64_t i = 1; i < digits; ++i) {
+          row[x + i] = static_cast<char>('0' + random.below(10));
+        }
+        x += digits; // keep the following field empty to separate numbers
+      } else if (random.chance(0.05)) {
+        row[x] = random.chance(0.2) ? '*' : symbols[random.below(symbols.size())];
+      }
+    }
+    out << row << '\n';
+  }
+}
+
+
+// 04: SIZE cards with 10 winning and 25 own numbers. Mostly 0-2 matches, so the card copies of part 2 don't overflow.
+void generate04(int64_t size, Random& random, Output& out) {
+  std::vector<int64_t> numbers(99);
+  std::iota(numbers.begin(), numbers.end(), 1);
+  auto width = std::to_string(size).size();
+  for (int64_t card = 1; card <= size; ++card) {
+    random.shuffle(numbers);
+    auto winning = std::vector<int64_t>(numbers.begin(), numbers.begin() + 10);
+    auto own = std::vector<int64_t>(numbers.begin() + 10, numbers.begin() + 35);
+    auto matches = random.chance(0.6) ? 0 : random.between(1, 2);
+    std::copy_n(winning.begin(), matches, own.begin());
+    random.shuffle(own);
+
+    auto id = std::to_string(card);
+    out << "Card " << std::string(width - id.size(), ' ') << id << ':';
+    for (auto number : winning) {
+      out << (number < 10 ? "  " : " ") << number;
+    }
+    out << " |";
+    for (auto number : own) {
+      out << (number < 10 ? "  " : " ") << number;
+    }
+    out << '\n';
+  }
+}
+
+
+// 05: almanac with 10 seed ranges and SIZE ranges per map, which partition [0; 2^32)
+void generate05(int64_t size, Random& random, Output& out) {
+  constexpr int64_t limit = int64_t(1) << 32;
+  out << "seeds:";
+  for (int i = 0; i < 10; ++i) {
+    auto start = random.between(0, limit - (int64_t(1) << 28));
+    out << ' ' << start << ' ' << random.between(1, int64_t(1) << 28);
+  }
+  out << "\n";
+
+  const std::vector<std::string_view> categories = { "seed", "soil", "fertilizer", "water", "light", "temperature", "humidity", "location" };
+  for (size_t map = 0; map + 1 < categories.size(); ++map) {
+    out << '\n' << categories[map] << "-to-" << categories[map + 1] << " map:\n";
+
+    std::vector<int64_t> bounds = { 0, limit };
+    for (int64_t i = 1; i < size; ++i) {
+      bounds.push_back(random.between(1, limit - 1));
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+      auto length = bounds[i + 1] - bounds[i];
+      out << random.between(0, limit - length) << ' ' << bounds[i] << ' ' << length << '\n';
+    }
+  }
+}
+
+
+// 06: SIZE races, at most 4, because part 2 concatenates all numbers into one race
+void generate06(int64_t size, Random& random, Output& out) {
+  std::vector<int64_t> times, records;
+  for (int64_t race = 0; race < std::clamp<int64_t>(size, 1, 4); ++race) {
+    auto time = random.between(10, 99);
+    times.push_back(time);
+    records.push_back(random.between(time, time * time / 4 - 1));
+  }
+
+  out << "Time:    ";
+  for (auto time : times) {
+    out << "     " << time;
+  }
+  out << "\nDistance:";
+  for (auto record : records) {
+    out << "  " << record;
+  }
+  out << '\n';
+}
+
+
+// 07: SIZE hands with bids up to 1000
+void generate07(int64_t size, Random& random, Output& out) {
+  const std::string_view cards = "23456789TJQKA";
+  for (int64_t hand = 0; hand < size; ++hand) {
+    char text[5];
+    for (auto& card : text) {
+      card = cards[random.below(cards.size())];
+    }
+    out << std::string_view(text, 5) << ' ' << random.between(1, 1000) << '\n';
+  }
+}
+
+
+/** 08: About SIZE nodes in the structure of the puzzle input, which both parts rely on: each ghost start node xxA leads into
+ *  a cycle, whose last node is the only xxZ node and leads back to the successor of xxA. The cycle lengths are multiples
+ *  of the instruction count with distinct prime factors. Both successors of a node are the same, so the L/R instructions
+ *  only matter for the loop detection.
+ */
+void generate08(int64_t size, Random& random, Output& out) {
+  constexpr int64_t instructionCount = 263;
+  auto isPrime = [](int64_t n) {
+    for (int64_t d = 2; d * d <= n; ++d) {
+      if (n % d == 0) return false;
+    }
+    return n > 1;
+  };
+
+  // Reduce the number of ghosts for huge graphs, so that the least common multiple of all cycles fits into 64 bit
+  std::vector<int64_t> primes;
+  for (int ghosts = 6; ghosts > 0 && primes.empty(); --ghosts) {
+    auto prime = std::max<int64_t>(2, size / (ghosts * instructionCount));
+    double product = instructionCount;
+    for (int i = 0; i < ghosts; ++i, ++prime) {
+      while (!isPrime(prime) || prime == instructionCount) {
+        ++prime;
+      }
+      primes.push_back(prime);
+      product *= prime;
+    }
+    if (product > 1e18) {
+      primes.clear();
+    }
+  }
+
+  for (int64_t i = 0; i < instructionCount; ++i) {
+    out << (random.chance(0.5) ? 'L' : 'R');
+  }
+  out << "\n\n";
+
+  // Names with at least 3 letters, the last one of which is reserved for A and Z nodes
+  auto nameLength = 3;
+  for (int64_t names = 26 * 26 * 24; names < 2 * size; names *= 26) {
+    ++nameLength;
+  }
+  auto name = [&](int64_t index, char last) {
+    std::string result(nameLength, last);
+    for (int pos = nameLength - 2; pos >= 0; --pos, index /= 26) {
+      result[pos] = static_cast<char>('A' + index % 26);
+    }
+    return result;
+  };
+
+  std::vector<std::string> lines;
+  int64_t nextIndex = 0;
+  auto middleName = [&] {
+    auto index = nextIndex++;
+    return name(index / 24, static_cast<char>('B' + index % 24));
+  };
+
+  for (size_t ghost = 0; ghost < primes.size(); ++ghost) {
+    auto startName = (ghost == 0) ? "AAA" : name(ghost, 'A');
+    auto endName = (ghost == 0) ? "ZZZ" : name(ghost, 'Z');
+
+    std::vector<std::string> cycle; // all nodes after the start node
+    for (int64_t i = 0; i + 1 < instructionCount * primes[ghost]; ++i) {
+      cycle.push_back(middleName());
+    }
+    cycle.push_back(endName);
+
+    auto edge = [](const std::string& from, const std::string& to) { return from + " = (" + to + ", " + to + ")"; };
+    lines.push_back(edge(startName, cycle.front()));
+    for (size_t i = 0; i + 1 < cycle.size(); ++i) {
+      lines.push_back(edge(cycle[i], cycle[i + 1]));
+    }
+    lines.push_back(edge(cycle.back(), cycle.front()));
+  }
+
+  random.shuffle(lines);
+  for (auto& line : lines) {
+    out << line << '\n';
+  }
+}
+
+
+// 09: SIZE sequences of 21 values of random polynomials up to degree 5
+void generate09(int64_t size, Random& random, Output& out) {
+  for (int64_t line = 0; line < size; ++line) {
+    std::array<int64_t, 6> coefficients = {};
+    auto degree = random.between(1, 5);
+    for (int64_t i = 0; i <= degree; ++i) {
+      coefficients[i] = random.between(-3, 3);
+    }
+
+    for (int64_t x = 0; x < 21; ++x) {
+      int64_t value = 0;
+      for (int64_t i = degree; i >= 0; --i) {
+        value = value * x + coefficients[i];
+      }
+      out << (x ? " " : "") << value;
+    }
+    out << '\n';
+  }
+}
+
+
+/** 10: SIZE x SIZE field with one loop, whose upper and lower edges follow random walks through the upper and lower
+ *  half of the field. All other tiles are random pipes or ground.
+ */
+void generate10(int64_t size, Random& random, Output& out) {
+  size = std::max<int64_t>(size, 8);
+  auto width = size, height = size;
+
+  // Upper and lower edge height per column (equal in the first/last two columns, so that the loop doesn't touch itself)
+  std::vector<int64_t> upper(width), lower(width);
+  upper[0] = random.between(1, height / 2 - 1);
+  lower[0] = random.between(height / 2 + 1, height - 2);
+  for (int64_t x = 1; x < width; ++x) {
+    bool edge = (x == 1 || x == width - 1);
+    upper[x] = edge ? upper[x - 1] : std::clamp(upper[x - 1] + random.between(-3, 3), int64_t(1), height / 2 - 1);
+    lower[x] = edge ? lower[x - 1] : std::clamp(lower[x - 1] + random.between(-3, 3), height / 2 + 1, height - 2);
+  }
+
+  // Trace the loop: rightwards along the upper edge, down the last column, leftwards along the lower edge and up the first column
+  std::vector<std::pair<int64_t, int64_t>> loop; // (x, y)
+  auto moveVertically = [&](int64_t x, int64_t fromY, int64_t toY) {
+    for (auto y = fromY; y != toY;) {
+      y += (toY > y) ? 1 : -1;
+      loop.emplace_back(x, y);
+    }
+  };
+
+  loop.emplace_back(0, upper[0]);
+  for (int64_t x = 1; x < width; ++x) {
+    loop.emplace_back(x, upper[x - 1]);
+    moveVertically(x, upper[x - 1], upper[x]);
+  }
+  moveVertically(width - 1, upper[width - 1], lower[width - 1]);
+  for (int64_t x = width - 2; x >= 0; --x) {
+    loop.emplace_back(x, lower[x + 1]);
+    moveVertically(x, lower[x + 1], lower[x]);
+  }
+  moveVertically(0, lower[0], upper[0] + 1);
+
+  const std::string_view tiles = "|-LJ7F.";
+  std::vector<std::string> field(height, std::string(width, '.'));
+  for (auto& row : field) {
+    for (auto& tile : row) {
+      tile = random.chance(0.5) ? '.' : tiles[random.below(tiles.size())];
+    }
+  }
+
+  // The pipe of each loop tile connects to its predecessor and successor
+  auto directionChar = [](int64_t dx, int64_t dy) { return dx ? (dx > 0 ? 'R' : 'L') : (dy > 0 ? 'D' : 'U'); };
+  const std::map<std::string, char, std::less<>> pipes = {
+    { "DU", '|' }, { "LR", '-' }, { "RU", 'L' }, { "LU", 'J' }, { "DL", '7' }, { "DR", 'F' },
+  };
+  for (size_t i = 0; i < loop.size(); ++i) {
+    auto [x, y] = loop[i];
+    auto [prevX, prevY] = loop[(i + loop.size() - 1) % loop.size()];
+    auto [nextX, nextY] = loop[(i + 1) % loop.size()];
+    std::string connections = { directionChar(prevX - x, prevY - y), directionChar(nextX - x, nextY - y) };
+    std::sort(connections.begin(), connections.end());
+    field[y][x] = pipes.find(connections)->second;
+  }
+
+  // The start tile's other neighbours must not connect to it, so that its pipe can be inferred
+  auto [startX, startY] = loop.front();
+  field[startY][startX] = 'S';
+  for (auto [dx, dy] : { std::pair(1, 0), std::pair(-1, 0), std::pair(0, 1), std::pair(0, -1) }) {
+    auto x = startX + dx, y = startY + dy;
+    bool onLoop = (std::pair(x, y) == loop[1] || std::pair(x, y) == loop.back());
+    if (!onLoop && x >= 0 && x < width && y >= 0 && y < height) {
+      field[y][x] = '.';
+    }
+  }
+
+  for (auto& row : field) {
+    out << row << '\n';
+  }
+}
+
+}
+
+
+void write(int day, int64_t size, uint64_t seed, const Sink& sink) {
+  const std::map<int, std::function<void(int64_t, Random&, Output&)>> generators = {
+    { 1, generate01 }, { 2, generate02 }, { 3, generate03 }, { 4, generate04 }, { 5, generate05 },
+    { 6, generate06 }, { 7, generate07 }, { 8, generate08 }, { 9, generate09 }, { 10, generate10 },
+  };
+
+  auto generator = generators.find(day);
+  if (generator == generators.end()) {
+    throw std::invalid_argument("No generator for day " + std::to_string(day));
+  }
+
+  Random random(seed);
+  Output out(sink);
+  generator->second(size, random, out);
+  out.flush();
+}
+
+
+std::string input(int day, int64_t size, uint64_t seed) {
+  std::string text;
+  write(day, size, seed, [&](std::string_view chunk) { text += chunk; });
+  return text;
+}
+
+}
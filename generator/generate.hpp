@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace generate {
+
+// Receives the generated text in consecutive chunks
+using Sink = std::function<void(std::string_view chunk)>;
+
+/** Generates a valid input of the given size for the day and passes it to the sink in chunks of about 1 MiB, so that
+ *  inputs way larger than the memory can be written. The meaning of the size depends on the day (see the usage of
+ *  generator.cpp). The same day, size and seed produce the same input on every platform.
+ *  Throws std::invalid_argument if there is no generator for the day.
+ */
+void write(int day, int64_t size, uint64_t seed, const Sink& sink);
+
+// Returns the whole generated input (see write())
+std::string input(int day, int64_t size, uint64_t seed = 2023);
+
+}
@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#include "generate.hpp"
+
+// Writes synthetic puzzle inputs of arbitrary size to stdout:
+//
+//   generator DAY SIZE [SEED] > input.txt
+//
+// The meaning of SIZE depends on the day (see generate.cpp). The same DAY, SIZE and SEED produce the same
+// input on every platform.
+
+int main(int argc, char* argv[]) {
+  try {
+    if (argc < 3) {
+      throw std::invalid_argument("Missing arguments");
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY); // no CRLF conversion
+#endif
+    // Streamed in chunks, so the size of the input isn't limited by the memory
+    generate::write(std::atoi(argv[1]), std::stoll(argv[2]), (argc >= 4) ? std::stoull(argv[3]) : 2023, [](std::string_view chunk) {
+      std::fwrite(chunk.data(), 1, chunk.size(), stdout);
+    });
+    return 0;
+  } catch (const std::invalid_argument& e) {
+    std::cerr << e.what() << "\n\n"
+      << "Usage: generator DAY SIZE [SEED] > input.txt\n"
+      << "  SIZE is the number of lines for days 01, 02, 04, 07 and 09, the side length for days 03 and 10,\n"
+      << "  the ranges per map for day 05, the number of races (at most 4) for day 06 and the approximate\n"
+      << "  number of nodes for day 08.\n";
+    return 1;
+  }
+}
@@ -0,0 +1,62 @@
+#include "../03/03.cpp"
+#include "bench.hpp"
+
+namespace day03 {
+
+static bench::Registration benchmarks(3, [](std::string_view input, bench::Runner& runner) {
+  EngineView engine(input);
+
+  std::vector<Vector> digits; // hasAdjacentSymbol() is called for the digits of a number
+  for (auto row : engine.rows()) {
+    for (auto it = row.begin(), end = row.end(); it != end; ++it) {
+      if (std::isdigit(*it)) {
+        digits.push_back(it.pos);
+      }
+    }
+  }
+
+  std::vector<Vector> gears;
+  for (auto offset : engine.findOffsets('*')) {
+    gears.push_back(engine.fromOffset(offset));
+  }
+
+  // One item is one tile. The solution reads the grid through EngineView, which needs no construction at all.
+  auto tiles = static_cast<size_t>(engine.width()) * engine.height();
+  runner.run("Engine::Engine (copy)", tiles, [&] {
+    Engine copy(std::ispanstream { input });
+    bench::doNotOptimize(copy.at(Vector(0, 0)));
+  });
+
+  // Scalar search through the whole grid vs. vectorized search
+  runner.run("FieldView::findOffset('*') loop", tiles, [&] {
+    for (size_t offset = engine.findOffset('*'); offset != engine.npos; offset = engine.findOffset('*', offset + 1)) {
+      bench::doNotOptimize(offset);
+    }
+  });
+
+  runner.run("FieldView::findOffsets('*')", tiles, [&] {
+    for (auto offset : engine.findOffsets('*')) {
+      bench::doNotOptimize(offset);
+    }
+  });
+
+  runner.run("FieldView::findOffsets(symbols)", tiles, [&] {
+    for (auto offset : engine.findOffsets(~search::ByteClass::range('0', '9').add('.'))) {
+      bench::doNotOptimize(offset);
+    }
+  });
+
+  runner.run("Engine::hasAdjacentSymbol", digits.size(), [&] {
+    for (auto pos : digits) {
+      bench::doNotOptimize(engine.hasAdjacentSymbol(pos));
+    }
+  });
+
+  runner.run("Engine::findGearRatio", gears.size(), [&] {
+    for (auto pos : gears) {
+      bench::doNotOptimize(engine.findGearRatio(pos));
+    }
+  });
+});
+
+}
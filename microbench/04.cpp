@@ -0,0 +1,54 @@
+#include "../04/04.cpp"
+#include "bench.hpp"
+
+#include <charconv>
+#include <regex>
+
+namespace day04 {
+
+static bench::Registration benchmarks(4, [](std::string_view input, bench::Runner& runner) {
+  std::vector<std::string_view> lines;
+  for (auto line : text::lines(input)) {
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+
+  // One item is one card line, which is parsed into the sum of its numbers
+  runner.run("pattern::match (card line)", lines.size(), [&] {
+    for (auto line : lines) {
+      auto [number, winning, own] = pattern::match<"Card {int}: {ints} | {ints}">(line).value();
+      auto sum = number;
+      for (auto value : winning) {
+        sum += value;
+      }
+      for (auto value : own) {
+        sum += value;
+      }
+      bench::doNotOptimize(sum);
+    }
+  });
+
+  // The regular expressions, which the pattern replaced
+  const std::regex lineRegex("^Card +([0-9]+): (.*?)\\| (.*)$");
+  const std::regex numberRegex("[0-9]+");
+  auto toInt = [](const std::csub_match& match) {
+    int64_t value = 0;
+    std::from_chars(match.first, match.second, value);
+    return value;
+  };
+
+  runner.run("std::regex (card line)", lines.size(), [&] {
+    for (auto line : lines) {
+      std::cmatch match;
+      std::regex_match(line.data(), line.data() + line.size(), match, lineRegex);
+      auto sum = toInt(match[1]);
+      for (std::cregex_iterator it(match[2].first, match[3].second, numberRegex), end; it != end; ++it) {
+        sum += toInt((*it)[0]);
+      }
+      bench::doNotOptimize(sum);
+    }
+  });
+});
+
+}
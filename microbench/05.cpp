@@ -0,0 +1,78 @@
+#include "../05/05.cpp"
+#include "bench.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <regex>
+
+#include <shared/hash.hpp>
+#include <shared/lines.hpp>
+
+namespace day05 {
+
+static bench::Registration benchmarks(5, [](std::string_view input, bench::Runner& runner) {
+  Almanac almanac(std::ispanstream { input });
+
+  // The seeds and pseudo random values across the whole 32 bit range of the maps
+  auto values = almanac.seeds;
+  for (uint64_t i = 0; i < 4096; ++i) {
+    values.push_back(static_cast<int64_t>(hashing::mix(i) & 0xffffffff));
+  }
+
+  runner.run("Map::operator() (combined)", values.size(), [&] {
+    for (auto value : values) {
+      bench::doNotOptimize(almanac.combined(value));
+    }
+  });
+
+  runner.run("Map::operator() (all maps)", values.size(), [&] {
+    for (auto value : values) {
+      for (auto& map : almanac.maps) {
+        value = map(value);
+      }
+      bench::doNotOptimize(value);
+    }
+  });
+
+  // One item is one combination of two maps, like in the Almanac constructor
+  runner.run("Map::combine", almanac.maps.size() - 1, [&] {
+    auto combined = Map::combine(almanac.maps[0], almanac.maps[1]);
+    for (auto pos = almanac.maps.begin() + 2, end = almanac.maps.end(); pos != end; ++pos) {
+      combined = Map::combine(combined, *pos);
+    }
+    bench::doNotOptimize(combined.map.data());
+  });
+
+  // One item is one range line of a map
+  std::vector<std::string_view> rangeLines;
+  for (auto line : text::lines(input)) {
+    if (!line.empty() && std::isdigit(static_cast<unsigned char>(line[0]))) {
+      rangeLines.push_back(line);
+    }
+  }
+
+  runner.run("pattern::match (range line)", rangeLines.size(), [&] {
+    for (auto line : rangeLines) {
+      auto [destination, source, length] = pattern::match<"{int} {int} {int}">(line).value();
+      bench::doNotOptimize(destination + source + length);
+    }
+  });
+
+  // The regular expression, which the pattern replaced
+  const std::regex rangeRegex("([0-9]+) ([0-9]+) ([0-9]+)");
+  auto toInt = [](const std::csub_match& match) {
+    int64_t value = 0;
+    std::from_chars(match.first, match.second, value);
+    return value;
+  };
+
+  runner.run("std::regex (range line)", rangeLines.size(), [&] {
+    for (auto line : rangeLines) {
+      std::cmatch match;
+      std::regex_match(line.data(), line.data() + line.size(), match, rangeRegex);
+      bench::doNotOptimize(toInt(match[1]) + toInt(match[2]) + toInt(match[3]));
+    }
+  });
+});
+
+}
@@ -0,0 +1,29 @@
+#include "../07/07.cpp"
+#include "bench.hpp"
+
+namespace day07 {
+
+static bench::Registration benchmarks(7, [](std::string_view input, bench::Runner& runner) {
+  auto hands = readHands(std::ispanstream(input));
+
+  runner.run("Hand::calcStrength", hands.size(), [&] {
+    for (auto& hand : hands) {
+      bench::doNotOptimize(hand.calcStrength());
+    }
+  });
+
+  runner.run("Hand::calcStrength (jokers)", hands.size(), [&] {
+    for (auto& hand : hands) {
+      bench::doNotOptimize(hand.calcStrength(true));
+    }
+  });
+
+  // Compares the hands in input order, so that the branches are as unpredictable as during sorting
+  runner.run("Hand::operator<", hands.size() - 1, [&] {
+    for (size_t i = 1; i < hands.size(); ++i) {
+      bench::doNotOptimize(hands[i - 1] < hands[i]);
+    }
+  });
+});
+
+}
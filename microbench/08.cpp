@@ -0,0 +1,52 @@
+#include "../08/08.cpp"
+#include "bench.hpp"
+
+#include <regex>
+
+namespace day08 {
+
+static bench::Registration benchmarks(8, [](std::string_view input, bench::Runner& runner) {
+  Solution solution;
+  solution.parse(input);
+  auto startNodes = solution.network.ghostStartNodes();
+
+  // One item is one step through the network until the loop is detected
+  size_t steps = 0;
+  for (auto node : startNodes) {
+    auto loop = NodeLoop::calculate(node, solution.instructions);
+    steps += loop.head + loop.period + 1;
+  }
+
+  runner.run("NodeLoop::calculate", steps, [&] {
+    for (auto node : startNodes) {
+      bench::doNotOptimize(NodeLoop::calculate(node, solution.instructions));
+    }
+  });
+
+  // One item is one node line
+  std::vector<std::string_view> nodeLines;
+  for (auto line : text::lines(input)) {
+    if (line.find(" = (") != std::string_view::npos) {
+      nodeLines.push_back(line);
+    }
+  }
+
+  runner.run("pattern::match (node line)", nodeLines.size(), [&] {
+    for (auto line : nodeLines) {
+      auto [name, left, right] = pattern::match<"{word} = ({word}, {word})">(line).value();
+      bench::doNotOptimize(name.size() + left.size() + right.size());
+    }
+  });
+
+  // The regular expression, which the pattern replaced
+  const std::regex lineRegex("^([A-Z0-9]+) = \\(([A-Z0-9]+), ([A-Z0-9]+)\\)$");
+  runner.run("std::regex (node line)", nodeLines.size(), [&] {
+    for (auto line : nodeLines) {
+      std::cmatch match;
+      std::regex_match(line.data(), line.data() + line.size(), match, lineRegex);
+      bench::doNotOptimize(match[1].length() + match[2].length() + match[3].length());
+    }
+  });
+});
+
+}
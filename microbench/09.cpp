@@ -0,0 +1,19 @@
+#include "../09/09.cpp"
+#include "bench.hpp"
+
+namespace day09 {
+
+static bench::Registration benchmarks(9, [](std::string_view input, bench::Runner& runner) {
+  Solution solution;
+  solution.parse(input);
+
+  runner.run("calculatePreviousAndNext", solution.sequences.size(), [&] {
+    Arena arena;
+    for (auto& numbers : solution.sequences) {
+      bench::doNotOptimize(calculatePreviousAndNext(numbers, arena));
+      arena.reset();
+    }
+  });
+});
+
+}
@@ -0,0 +1,39 @@
+#include "../10/10.cpp"
+#include "bench.hpp"
+
+namespace day10 {
+
+static bench::Registration benchmarks(10, [](std::string_view input, bench::Runner& runner) {
+  PipeFieldView field(input);
+  auto loop = field.findLoop(field.getStartOffset());
+
+  // One item is one tile
+  runner.run("PipeField::PipeField (copy)", field.tileCount, [&] {
+    PipeField copy(std::ispanstream { input });
+    bench::doNotOptimize(copy.tileCount);
+  });
+
+  // One item is one tile of the loop
+  runner.run("PipeField::findLoop", loop.offsets.size(), [&] {
+    bench::doNotOptimize(field.findLoop(field.getStartOffset()));
+  });
+
+  runner.run("PipeField::countEnclosedFields", loop.offsets.size(), [&] {
+    bench::doNotOptimize(field.countEnclosedFields(loop));
+  });
+
+  // One item is one tile of the field
+  LoopIndex index(field, loop);
+  auto stride = static_cast<size_t>(field.stride);
+  runner.run("LoopIndex::contains", field.tileCount, [&] {
+    size_t inside = 0;
+    for (size_t y = 0, height = field.tileCount / stride; y < height; ++y) {
+      for (size_t x = 0; x < stride; ++x) {
+        inside += index.contains(x, y);
+      }
+    }
+    bench::doNotOptimize(inside);
+  });
+});
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/** Microbenchmarks of single functions of the days, e.g. to prove a kernel level speedup, which would vanish in the
+ *  noise of the whole program's runtime.
+ *
+ *  Each day registers a function, which prepares its data from an input text and times its hot functions:
+ *
+ *    static bench::Registration benchmarks(5, [](std::string_view input, bench::Runner& runner) {
+ *      Almanac almanac(std::ispanstream(input));
+ *      runner.run("Map::operator()", values.size(), [&] {
+ *        for (auto value : values) {
+ *          bench::doNotOptimize(almanac.combined(value));
+ *        }
+ *      });
+ *    });
+ */
+namespace bench {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+inline const volatile void* sink;
+#endif
+
+// Forces the compiler to compute the value, even though it is never used
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER) && !defined(__clang__)
+  sink = &value; // MSVC has no inline assembly on x64, so the value escapes through a volatile store
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+// Forces the compiler to assume that all memory may have been read and written
+inline void clobberMemory() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  _ReadWriteBarrier();
+#else
+  asm volatile("" : : : "memory");
+#endif
+}
+
+
+struct Options {
+  int samples = 30;            // timed samples per benchmark
+  double minSampleTime = 10;   // milliseconds, the calls per sample are chosen to reach it
+  std::string filter;          // only run benchmarks whose name contains this
+};
+
+
+// Nanoseconds per item of all samples
+struct Statistics {
+  double min = 0;
+  double median = 0;
+  double lower = 0; // 95% confidence interval of the median
+  double upper = 0;
+};
+
+Statistics calcStatistics(std::vector<double> samples);
+
+
+class Runner {
+public:
+  Runner(const Options& options) : options(options) {}
+
+  /** Times func(), which processes the given number of items per call, and prints the time per item. The calls are
+   *  repeated in batches, which take at least options.minSampleTime, after an untimed warmup of one batch.
+   */
+  template<typename Func>
+  void run(std::string_view name, size_t items, Func&& func) {
+    if (!options.filter.empty() && name.find(options.filter) == std::string_view::npos) {
+      return;
+    }
+
+    // Calibrate the calls per sample with the first call (which also warms up caches and branch predictors)
+    auto firstCall = measure(1, func);
+    auto calls = static_cast<size_t>(std::max(1.0, options.minSampleTime * 1e6 / std::max(firstCall, 1.0)));
+    measure(calls, func);
+
+    std::vector<double> samples;
+    for (int i = 0; i < options.samples; ++i) {
+      samples.push_back(measure(calls, func) / calls / std::max<size_t>(items, 1));
+    }
+    report(name, items, calls, calcStatistics(std::move(samples)));
+  }
+
+private:
+  // Returns the nanoseconds of calling func() the given number of times
+  template<typename Func>
+  static double measure(size_t calls, Func& func) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i) {
+      func();
+      clobberMemory();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void report(std::string_view name, size_t items, size_t calls, const Statistics& statistics) const;
+
+  const Options& options;
+};
+
+
+using Benchmark = std::function<void(std::string_view input, Runner& runner)>;
+
+// Benchmark functions by day
+inline std::map<int, Benchmark>& registry() {
+  static std::map<int, Benchmark> benchmarks; // function local to not depend on the static initialization order
+  return benchmarks;
+}
+
+struct Registration {
+  Registration(int day, Benchmark benchmark) {
+    registry()[day] = std::move(benchmark);
+  }
+};
+
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <shared/mapped_file.hpp>
+
+#include "../generator/generate.hpp"
+#include "bench.hpp"
+
+// The days are compiled into the NN.cpp files of this project with AOC_DRIVER defined (like in the driver), which gives
+// their benchmarks access to the types of the day.
+
+namespace bench {
+
+Statistics calcStatistics(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  auto n = samples.size();
+
+  // Distribution free confidence interval of the median from the order statistics: the median lies between the
+  // samples of rank n/2 -+ 0.98*sqrt(n) with a probability of 95% (normal approximation of the binomial distribution)
+  auto spread = 0.98 * std::sqrt(static_cast<double>(n));
+  auto rank = [&](double rank) { return samples[static_cast<size_t>(std::clamp(rank, 1.0, static_cast<double>(n))) - 1]; };
+  return Statistics {
+    .min = samples.front(),
+    .median = (n % 2) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2,
+    .lower = rank(std::floor(n / 2.0 - spread)),
+    .upper = rank(std::ceil(n / 2.0 + 1 + spread)),
+  };
+}
+
+
+void Runner::report(std::string_view name, size_t items, size_t calls, const Statistics& statistics) const {
+  std::cout << std::format("  {:<36} {:>12.2f}ns [{:.2f}, {:.2f}]  min {:.2f}ns  ({} items x {} calls/sample)\n",
+    name, statistics.median, statistics.lower, statistics.upper, statistics.min, items, calls);
+}
+
+}
+
+
+struct Options {
+  bench::Options bench;
+  std::string dataDir = "../data"; // contains the inputs as NN/input.txt
+  bool puzzleInputs = true;
+  bool generatedInputs = true;
+  std::vector<int> days; // days to run (all days with benchmarks if empty)
+};
+
+
+// Size of the generated input for each day (see generate.cpp), about 10-100 times the puzzle input
+const std::map<int, int64_t> generatedSizes = {
+  { 3, 1000 }, { 5, 5000 }, { 7, 100000 }, { 8, 200000 }, { 9, 200000 }, { 10, 1000 },
+};
+
+
+/** Parses the command line:
+ *    microbench [--samples N] [--min-time MS] [--filter NAME] [--data DIR] [--puzzle-only|--generated-only] [day...]
+ */
+Options parseOptions(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    if (arg == "--samples" && i + 1 < argc) {
+      options.bench.samples = std::max(1, std::stoi(argv[++i]));
+    } else if (arg == "--min-time" && i + 1 < argc) {
+      options.bench.minSampleTime = std::stod(argv[++i]);
+    } else if (arg == "--filter" && i + 1 < argc) {
+      options.bench.filter = argv[++i];
+    } else if (arg == "--data" && i + 1 < argc) {
+      options.dataDir = argv[++i];
+    } else if (arg == "--puzzle-only") {
+      options.generatedInputs = false;
+    } else if (arg == "--generated-only") {
+      options.puzzleInputs = false;
+    } else if (!arg.empty() && std::isdigit(static_cast<unsigned char>(arg[0]))) {
+      options.days.push_back(std::stoi(std::string(arg)));
+    } else {
+      std::cerr << "Unknown argument: " << arg << "\n";
+      std::exit(1);
+    }
+  }
+
+  if (options.days.empty()) {
+    for (auto& [day, benchmark] : bench::registry()) {
+      options.days.push_back(day);
+    }
+  }
+  return options;
+}
+
+
+int main(int argc, char* argv[]) {
+  auto options = parseOptions(argc, argv);
+  bench::Runner runner(options.bench);
+
+  std::cout << "Nanoseconds per item: median [95% confidence interval of the median]\n";
+  int errors = 0;
+  for (auto day : options.days) {
+    auto benchmark = bench::registry().find(day);
+    if (benchmark == bench::registry().end()) {
+      std::cout << std::format("\n{:02d}: No benchmarks registered\n", day);
+      ++errors;
+      continue;
+    }
+
+    if (options.puzzleInputs) {
+      auto path = std::filesystem::path(options.dataDir) / std::format("{:02d}", day) / "input.txt";
+      try {
+        MappedFile input(path.string());
+        std::cout << std::format("\n{:02d} {} ({} bytes)\n", day, path.string(), input.view().size());
+        benchmark->second(input.view(), runner);
+      } catch (const std::runtime_error& e) {
+        std::cout << std::format("\n{:02d} {}\n", day, e.what());
+        ++errors;
+      }
+    }
+
+    if (options.generatedInputs) {
+      auto size = generatedSizes.contains(day) ? generatedSizes.at(day) : 1000;
+      auto input = generate::input(day, size);
+      std::cout << std::format("\n{:02d} generated (size {}, {} bytes)\n", day, size, input.size());
+      benchmark->second(input, runner);
+    }
+  }
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+/** Heap allocation counters of the current thread, which are updated by the global operator new/delete 
+ *  replacements in allocation_hooks.hpp if AOC_ALLOC_STATS is defined. 
+ *  The timing scopes report the allocations per phase based on these counters.
+ */
+namespace allocation {
+
+#ifdef AOC_ALLOC_STATS
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+struct Counters {
+  uint64_t allocations = 0; // number of calls to operator new
+  uint64_t bytes = 0;       // total bytes requested
+  int64_t live = 0;         // bytes currently allocated by this thread (negative if it frees memory of other threads)
+  int64_t peak = 0;         // maximum of live since the last reset by a timing scope
+};
+
+inline constinit thread_local Counters counters;
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#ifdef AOC_ALLOC_STATS
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "allocation.hpp"
+
+/** Replaces the global operator new/delete to count allocations in allocation::counters.
+ *  The replacements must exist exactly once per executable, so this header may only be included by one translation unit
+ *  (solver.hpp includes it for the standalone day executables and driver.cpp for the driver).
+ *
+ *  Each block is prefixed with its size to account for unsized deletes. Over-aligned allocations keep using 
+ *  the default implementation and are not counted.
+ */
+namespace allocation {
+  constexpr size_t headerSize = alignof(std::max_align_t); // keeps the returned pointer aligned
+
+  inline void* allocate(size_t size) noexcept {
+    auto block = static_cast<char*>(std::malloc(size + headerSize));
+    if (!block) {
+      return nullptr;
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+
+    auto& c = counters;
+    ++c.allocations;
+    c.bytes += size;
+    c.live += size;
+    if (c.live > c.peak) {
+      c.peak = c.live;
+    }
+    return block + headerSize;
+  }
+
+  inline void deallocate(void* ptr) noexcept {
+    if (ptr) {
+      auto block = static_cast<char*>(ptr) - headerSize;
+      counters.live -= *reinterpret_cast<size_t*>(block);
+      std::free(block);
+    }
+  }
+
+  inline void* allocateOrThrow(size_t size) {
+    if (auto ptr = allocate(size)) {
+      return ptr;
+    }
+    throw std::bad_alloc();
+  }
+}
+
+void* operator new(size_t size) { return allocation::allocateOrThrow(size); }
+void* operator new[](size_t size) { return allocation::allocateOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocation::allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocation::allocate(size); }
+
+void operator delete(void* ptr) noexcept { allocation::deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { allocation::deallocate(ptr); }
+void operator delete(void* ptr, size_t) noexcept { allocation::deallocate(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { allocation::deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { allocation::deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { allocation::deallocate(ptr); }
+
+#endif
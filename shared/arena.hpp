@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+/** Scratch memory for short-lived containers (e.g. the temporaries of parsing a single line), which is handed out by 
+ *  bumping a pointer and freed all at once by reset(). Use it through std::pmr containers:
+ *
+ *    Arena arena;
+ *    for (auto line : lines) {
+ *      std::pmr::vector<int> numbers(arena);
+ *      ...
+ *      arena.reset(); // no container may use the arena's memory after this
+ *    }
+ *
+ *  Allocations beyond the initial buffer are taken from the heap in growing chunks and returned by reset(), so the initial 
+ *  size should cover one iteration to avoid touching the heap at all.
+ */
+class Arena {
+public:
+  explicit Arena(size_t size = 64 * 1024) : buffer(std::make_unique_for_overwrite<std::byte[]>(size)), resource(buffer.get(), size) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  std::pmr::memory_resource* memory() { return &resource; }
+  operator std::pmr::memory_resource*() { return &resource; }
+
+  void reset() { resource.release(); }
+
+private:
+  std::unique_ptr<std::byte[]> buffer;
+  std::pmr::monotonic_buffer_resource resource;
+};
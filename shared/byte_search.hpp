@@ -0,0 +1,320 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AOC_BYTE_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
+/** Vectorized search for all bytes of a text, which belong to a set of byte values:
+ *
+ *    auto symbols = ~search::ByteClass::range('0', '9').add('.');
+ *    for (auto offset : search::findAll(text, symbols)) { ... }
+ *
+ *  The text is compared 64 bytes at a time (with SSE2 if available) into a bit mask of matches, whose set bits are
+ *  then iterated. A class is compared as up to MaxRanges ranges of byte values or as the complement of them,
+ *  whichever needs fewer. Classes with more ranges fall back to a table lookup per byte.
+ */
+namespace search {
+
+class ByteClass {
+public:
+  static constexpr size_t MaxRanges = 4;
+
+  ByteClass() = default;
+  ByteClass(char ch) { add(ch); }
+  ByteClass(std::initializer_list<char> chars) {
+    for (auto ch : chars) {
+      add(ch);
+    }
+  }
+
+  static ByteClass range(char first, char last) { return ByteClass().addRange(first, last); }
+
+  // All bytes for which predicate(char) is true
+  template<typename Predicate>
+  static ByteClass where(Predicate&& predicate) {
+    ByteClass result;
+    for (int byte = 0; byte < 256; ++byte) {
+      if (predicate(static_cast<char>(byte))) {
+        result.add(static_cast<char>(byte));
+      }
+    }
+    return result;
+  }
+
+  ByteClass& add(char ch) {
+    auto byte = static_cast<uint8_t>(ch);
+    bits[byte / 64] |= uint64_t(1) << (byte % 64);
+    return *this;
+  }
+
+  ByteClass& addRange(char first, char last) {
+    for (int byte = static_cast<uint8_t>(first); byte <= static_cast<uint8_t>(last); ++byte) {
+      add(static_cast<char>(byte));
+    }
+    return *this;
+  }
+
+  ByteClass& remove(char ch) {
+    auto byte = static_cast<uint8_t>(ch);
+    bits[byte / 64] &= ~(uint64_t(1) << (byte % 64));
+    return *this;
+  }
+
+  ByteClass operator~() const {
+    ByteClass result;
+    for (size_t i = 0; i < bits.size(); ++i) {
+      result.bits[i] = ~bits[i];
+    }
+    return result;
+  }
+
+  bool contains(char ch) const {
+    auto byte = static_cast<uint8_t>(ch);
+    return (bits[byte / 64] >> (byte % 64)) & 1;
+  }
+
+  bool operator==(const ByteClass&) const = default;
+
+private:
+  friend class Matcher;
+  std::array<uint64_t, 4> bits = {};
+};
+
+
+/** Compares blocks of 64 bytes against a ByteClass. Prepared once per search from the class.
+ */
+class Matcher {
+public:
+  static constexpr size_t BlockSize = 64; // four SSE2 registers
+
+  explicit Matcher(const ByteClass& bytes) : bytes(bytes) {
+    // Use the complement if it consists of fewer ranges (e.g. "everything except digits and '.'")
+    auto direct = collectRanges(bytes, false);
+    auto complement = collectRanges(bytes, true);
+    bool negated = complement.count < direct.count;
+    auto& chosen = negated ? complement : direct;
+    vectorized = chosen.count <= ByteClass::MaxRanges;
+    rangeCount = std::min(chosen.count, ByteClass::MaxRanges);
+    invert = negated ? ~uint64_t(0) : 0;
+#ifdef AOC_BYTE_SEARCH_SSE2
+    for (size_t i = 0; i < rangeCount; ++i) {
+      first[i] = _mm_set1_epi8(static_cast<char>(chosen.first[i]));
+      limit[i] = _mm_set1_epi8(static_cast<char>(chosen.last[i] - chosen.first[i]));
+    }
+#endif
+  }
+
+  // Bit i is set if block[i] is in the class
+  uint64_t match(const char* block) const {
+#ifdef AOC_BYTE_SEARCH_SSE2
+    // Dispatch to loops unrolled for the number of ranges
+    switch (vectorized ? rangeCount : ByteClass::MaxRanges + 1) {
+      case 0: return invert;
+      case 1: return matchRanges<1>(block, first, limit);
+      case 2: return matchRanges<2>(block, first, limit);
+      case 3: return matchRanges<3>(block, first, limit);
+      case 4: return matchRanges<4>(block, first, limit);
+    }
+#endif
+    uint64_t mask = 0;
+    for (size_t i = 0; i < BlockSize; ++i) {
+      mask |= static_cast<uint64_t>(bytes.contains(block[i])) << i;
+    }
+    return mask;
+  }
+
+  /** Returns the offset of the first complete block at or after offset (in steps of BlockSize) with a match and 
+   *  its match mask, or the offset behind the last complete block and mask 0.
+   */
+  size_t findBlock(const char* data, size_t offset, size_t size, uint64_t& mask) const {
+#ifdef AOC_BYTE_SEARCH_SSE2
+    switch (vectorized ? rangeCount : ByteClass::MaxRanges + 1) {
+      case 1: return findBlockWithRanges<1>(data, offset, size, mask);
+      case 2: return findBlockWithRanges<2>(data, offset, size, mask);
+      case 3: return findBlockWithRanges<3>(data, offset, size, mask);
+      case 4: return findBlockWithRanges<4>(data, offset, size, mask);
+    }
+#endif
+    for (; offset + BlockSize <= size; offset += BlockSize) {
+      if ((mask = match(data + offset))) {
+        return offset;
+      }
+    }
+    mask = 0;
+    return offset;
+  }
+
+private:
+#ifdef AOC_BYTE_SEARCH_SSE2
+  // The search loop with the ranges in registers
+  template<size_t Count>
+  size_t findBlockWithRanges(const char* data, size_t offset, size_t size, uint64_t& mask) const {
+    __m128i firsts[Count], limits[Count];
+    std::copy_n(first, Count, firsts);
+    std::copy_n(limit, Count, limits);
+    for (; offset + BlockSize <= size; offset += BlockSize) {
+      if (auto found = matchRanges<Count>(data + offset, firsts, limits)) {
+        mask = found;
+        return offset;
+      }
+    }
+    mask = 0;
+    return offset;
+  }
+
+  template<size_t Count>
+  uint64_t matchRanges(const char* block, const __m128i* first, const __m128i* limit) const {
+    static_assert(Count <= ByteClass::MaxRanges);
+    uint64_t mask = 0;
+    for (size_t part = 0; part < BlockSize / 16; ++part) {
+      auto values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * part));
+      auto inRange = _mm_setzero_si128();
+      for (size_t i = 0; i < Count; ++i) {
+        // value - first <= last - first as unsigned bytes (SSE2 has no unsigned comparison, but an unsigned minimum)
+        auto offset = _mm_sub_epi8(values, first[i]);
+        inRange = _mm_or_si128(inRange, _mm_cmpeq_epi8(_mm_min_epu8(offset, limit[i]), offset));
+      }
+      mask |= static_cast<uint64_t>(_mm_movemask_epi8(inRange)) << (16 * part);
+    }
+    return mask ^ invert;
+  }
+#endif
+
+  struct Ranges {
+    std::array<uint8_t, 256> first = {};
+    std::array<uint8_t, 256> last = {};
+    size_t count = 0;
+  };
+
+  static Ranges collectRanges(const ByteClass& bytes, bool complement) {
+    Ranges ranges;
+    for (int byte = 0; byte < 256;) {
+      if (bytes.contains(static_cast<char>(byte)) != complement) {
+        auto begin = byte;
+        while (byte < 256 && bytes.contains(static_cast<char>(byte)) != complement) {
+          ++byte;
+        }
+        ranges.first[ranges.count] = static_cast<uint8_t>(begin);
+        ranges.last[ranges.count] = static_cast<uint8_t>(byte - 1);
+        ++ranges.count;
+      } else {
+        ++byte;
+      }
+    }
+    return ranges;
+  }
+
+  ByteClass bytes;
+#ifdef AOC_BYTE_SEARCH_SSE2
+  __m128i first[ByteClass::MaxRanges];
+  __m128i limit[ByteClass::MaxRanges]; // last - first of each range
+#endif
+  size_t rangeCount = 0;
+  uint64_t invert = 0; // all bits to match the complement of the ranges
+  bool vectorized = false;
+};
+
+
+/** View of the offsets of all bytes of a text in a ByteClass in ascending order
+ */
+class Matches : public std::ranges::view_interface<Matches> {
+public:
+  class Iterator {
+  public:
+    using value_type = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const Matches* matches, size_t blockStart) : matches(matches), blockStart(blockStart) {
+      mask = matches->matchBlock(blockStart);
+      skipEmpty();
+    }
+
+    size_t operator*() const { return blockStart + std::countr_zero(mask); }
+
+    Iterator& operator++() {
+      mask &= mask - 1;
+      skipEmpty();
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return blockStart == other.blockStart && mask == other.mask; }
+    bool operator==(std::default_sentinel_t) const { return blockStart >= matches->text.size(); }
+
+  private:
+    void skipEmpty() {
+      if (mask) {
+        return;
+      }
+      auto size = matches->text.size();
+      blockStart = matches->matcher.findBlock(matches->text.data(), blockStart + Matcher::BlockSize, size, mask);
+      if (!mask) {
+        mask = matches->matchBlock(blockStart); // the incomplete last block
+        if (!mask) {
+          blockStart = std::max(blockStart, size);
+        }
+      }
+    }
+
+    const Matches* matches = nullptr;
+    size_t blockStart = 0; // text offset of the current block
+    uint64_t mask = 0;     // remaining matches in the current block
+  };
+
+  Matches() = default;
+  Matches(std::string_view text, const ByteClass& bytes, size_t start = 0) : text(text), matcher(bytes), start(std::min(start, text.size())) {}
+
+  Iterator begin() const { return Iterator(this, start); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+  // Matches the block at the given offset, the last block is copied to not read behind the text
+  uint64_t matchBlock(size_t offset) const {
+    if (offset >= text.size()) {
+      return 0;
+    }
+    auto remaining = text.size() - offset;
+    if (remaining >= Matcher::BlockSize) {
+      return matcher.match(text.data() + offset);
+    }
+
+    char block[Matcher::BlockSize] = {};
+    std::memcpy(block, text.data() + offset, remaining);
+    return matcher.match(block) & ((uint64_t(1) << remaining) - 1);
+  }
+
+  std::string_view text;
+  Matcher matcher{ ByteClass() };
+  size_t start = 0;
+};
+
+
+// The offsets of all bytes of the text from start on, which are in the class
+inline Matches findAll(std::string_view text, const ByteClass& bytes, size_t start = 0) {
+  return Matches(text, bytes, start);
+}
+
+// The offset of the first byte of the text from start on, which is in the class, or std::string_view::npos
+inline size_t findFirst(std::string_view text, const ByteClass& bytes, size_t start = 0) {
+  auto matches = findAll(text, bytes, start);
+  auto first = matches.begin();
+  return (first != matches.end()) ? *first : std::string_view::npos;
+}
+
+}
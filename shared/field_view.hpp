@@ -0,0 +1,146 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <type_traits>
+
+#include <common/vector.hpp>
+
+#include "byte_search.hpp"
+
+/** Read-only grid directly on the text of a grid file (e.g. the memory mapped input), which doesn't copy the grid
+ *  like Field/FieldT do. It provides the same at(), operator[], rows(), rangeFromPositionAndDirection(), findOffset() and
+ *  fromOffset() interface (plus the vectorized findOffsets()), so types built on FieldT can be built on FieldView instead.
+ *
+ *  The tiles are converted from their characters with T(char) on each access. Offsets are offsets into the text,
+ *  so the row stride includes the line break ('\n' or "\r\n"). All rows must have the same length and the text must
+ *  outlive the view.
+ */
+template<typename T = char>
+class FieldView {
+public:
+  static constexpr size_t npos = std::numeric_limits<size_t>::max(); // returned by findOffset() like by FieldT
+
+  /** Iterates the tiles from a position in a direction. It compares equal to std::default_sentinel when leaving the
+   *  grid and to another iterator at the same position.
+   */
+  class Iterator {
+  public:
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const FieldView* field, Vector pos, Vector direction) : pos(pos), field(field), direction(direction) {}
+
+    T operator*() const { return (*field)[pos]; }
+
+    Iterator& operator++() {
+      pos += direction;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto copy = *this;
+      pos += direction;
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return pos == other.pos; }
+    bool operator==(std::default_sentinel_t) const { return !field->validPosition(pos); }
+
+    Vector pos;
+
+  private:
+    const FieldView* field = nullptr;
+    Vector direction;
+  };
+
+  // Tiles from a position in a direction until leaving the grid (a borrowed range, so algorithms may return its iterators)
+  using DirectionRange = std::ranges::subrange<Iterator, std::default_sentinel_t>;
+
+  // Tiles of one row from left to right (begin() and end() have the same type)
+  struct Row {
+    Iterator begin() const { return Iterator(field, Vector(0, y), Vector::Right); }
+    Iterator end() const { return Iterator(field, Vector(field->width(), y), Vector::Right); }
+
+    const FieldView* field;
+    int y;
+  };
+
+
+  FieldView() = default;
+  FieldView(std::string_view text) : text(text) {
+    auto lineEnd = text.find('\n');
+    fieldWidth = std::min(lineEnd, text.size());
+    rowStride = (lineEnd == std::string_view::npos) ? text.size() : lineEnd + 1;
+    if (fieldWidth > 0 && text[fieldWidth - 1] == '\r') {
+      --fieldWidth;
+    }
+    fieldHeight = rowStride ? (text.size() + rowStride - 1) / rowStride : 0; // the last row may lack the line break
+  }
+
+  int width() const { return static_cast<int>(fieldWidth); }
+  int height() const { return static_cast<int>(fieldHeight); }
+  size_t stride() const { return rowStride; }
+  std::string_view data() const { return text; }
+
+
+  bool validPosition(Vector pos) const {
+    return pos.x >= 0 && pos.y >= 0 && pos.x < width() && pos.y < height();
+  }
+
+  // @pre validPosition(pos)
+  T operator[](Vector pos) const { return T(text[toOffset(pos)]); }
+
+  std::optional<T> at(Vector pos) const {
+    return validPosition(pos) ? std::optional<T>((*this)[pos]) : std::nullopt;
+  }
+
+  T at(Vector pos, T outside) const {
+    return validPosition(pos) ? (*this)[pos] : outside;
+  }
+
+
+  size_t toOffset(Vector pos) const { return pos.y * rowStride + pos.x; }
+  Vector fromOffset(size_t offset) const { return Vector(static_cast<int>(offset % rowStride), static_cast<int>(offset / rowStride)); }
+
+  // Returns the offset of the first tile equal to value at or after start or npos
+  size_t findOffset(const T& value, size_t start = 0) const {
+    if constexpr (std::is_same_v<T, char>) {
+      auto offset = text.find(value, start); // line breaks never match a tile of the grid
+      return (offset != std::string_view::npos) ? offset : npos;
+    } else {
+      auto offset = search::findFirst(text, withoutLineBreaks(search::ByteClass::where([&](char ch) { return T(ch) == value; })), start);
+      return (offset != std::string_view::npos) ? offset : npos;
+    }
+  }
+
+  /** Offsets of all tiles in [start, end), whose character is in the given class (e.g. findOffsets('*') or 
+   *  findOffsets(~search::ByteClass::range('0', '9').add('.')) for all symbols), in ascending order
+   */
+  search::Matches findOffsets(const search::ByteClass& bytes, size_t start = 0, size_t end = npos) const {
+    return search::findAll(text.substr(0, end), withoutLineBreaks(bytes), start);
+  }
+
+
+  auto rows() const {
+    return std::views::iota(0, height()) | std::views::transform([this](int y) { return Row { this, y }; });
+  }
+
+  DirectionRange rangeFromPositionAndDirection(Vector pos, Vector direction) const {
+    return DirectionRange(Iterator(this, pos, direction), std::default_sentinel);
+  }
+
+private:
+  static search::ByteClass withoutLineBreaks(search::ByteClass bytes) {
+    return bytes.remove('\n').remove('\r');
+  }
+
+  std::string_view text;
+  size_t fieldWidth = 0;
+  size_t fieldHeight = 0;
+  size_t rowStride = 0;
+};
@@ -0,0 +1,315 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define AOC_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "hash.hpp"
+
+/** Open addressing hash tables, which store their values in one flat array instead of a node per value.
+ *
+ *  Each slot has a control byte, which is either Empty or holds the lowest 7 bits of the value's hash. Slots are probed
+ *  in groups of 16, whose control bytes are compared with the searched hash bits at once (with SSE2 if available),
+ *  so only slots with matching hash bits have to be compared with the key.
+ *
+ *  Inserting may move all values, so pointers and iterators into the table are invalidated by inserts.
+ *  There is no erase, since none of the days needs one.
+ */
+namespace flat {
+
+namespace detail {
+  constexpr int8_t Empty = -128;
+  constexpr size_t GroupSize = 16;
+
+  // Bit mask of the slots in a group of control bytes, which match a given control byte
+  struct Group {
+    explicit Group(const int8_t* ctrl) {
+#ifdef AOC_FLAT_HASH_SSE2
+      bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+      std::copy_n(ctrl, GroupSize, bytes);
+#endif
+    }
+
+    uint32_t match(int8_t value) const {
+#ifdef AOC_FLAT_HASH_SSE2
+      return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), bytes)));
+#else
+      uint32_t mask = 0;
+      for (size_t i = 0; i < GroupSize; ++i) {
+        mask |= static_cast<uint32_t>(bytes[i] == value) << i;
+      }
+      return mask;
+#endif
+    }
+
+#ifdef AOC_FLAT_HASH_SSE2
+    __m128i bytes;
+#else
+    int8_t bytes[GroupSize];
+#endif
+  };
+
+  struct Identity {
+    template<typename T>
+    const T& operator()(const T& value) const { return value; }
+  };
+
+  struct First {
+    template<typename T>
+    const auto& operator()(const T& value) const { return value.first; }
+  };
+}
+
+
+/** Common implementation of Set and Map. KeyOf extracts the key from a stored value.
+ */
+template<typename Value, typename Hash, typename KeyEqual, typename KeyOf>
+class Table {
+public:
+  using value_type = Value;
+
+  template<typename TableT, typename ValueT>
+  class IteratorT {
+  public:
+    using value_type = Table::value_type;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    IteratorT() = default;
+    IteratorT(TableT* table, size_t index) : table(table), index(index) { skipEmpty(); }
+    operator IteratorT<const Table, const Value>() const { return { table, index }; } // iterator -> const_iterator
+
+    ValueT& operator*() const { return table->slots[index].value; }
+    ValueT* operator->() const { return &table->slots[index].value; }
+
+    IteratorT& operator++() {
+      ++index;
+      skipEmpty();
+      return *this;
+    }
+    IteratorT operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const IteratorT& other) const { return index == other.index; }
+
+  private:
+    friend class Table;
+
+    void skipEmpty() {
+      while (index < table->ctrl.size() && table->ctrl[index] == detail::Empty) {
+        ++index;
+      }
+    }
+
+    TableT* table = nullptr;
+    size_t index = 0;
+  };
+
+  using iterator = IteratorT<Table, Value>;
+  using const_iterator = IteratorT<const Table, const Value>;
+
+
+  Table() = default;
+  Table(const Table& other) { *this = other; }
+  Table(Table&& other) noexcept { swap(other); }
+  ~Table() { clear(); }
+
+  Table& operator=(const Table& other) {
+    if (this != &other) {
+      clear();
+      reserve(other.size());
+      for (auto& value : other) {
+        insert(value);
+      }
+    }
+    return *this;
+  }
+
+  Table& operator=(Table&& other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  void swap(Table& other) noexcept {
+    std::swap(ctrl, other.ctrl);
+    std::swap(slots, other.slots);
+    std::swap(count, other.count);
+  }
+
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, ctrl.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, ctrl.size()); }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_t capacity() const { return ctrl.size(); }
+
+
+  // Allocates enough slots to hold the given number of values without rehashing
+  void reserve(size_t values) {
+    auto needed = std::bit_ceil(std::max(detail::GroupSize, (values * 8 + 6) / 7));
+    if (needed > ctrl.size()) {
+      rehash(needed);
+    }
+  }
+
+  void clear() {
+    for (size_t i = 0; i < ctrl.size(); ++i) {
+      if (ctrl[i] != detail::Empty) {
+        std::destroy_at(&slots[i].value);
+        ctrl[i] = detail::Empty;
+      }
+    }
+    count = 0;
+  }
+
+
+  template<typename Key>
+  iterator find(const Key& key) { return iterator(this, findIndex(key)); }
+
+  template<typename Key>
+  const_iterator find(const Key& key) const { return const_iterator(this, findIndex(key)); }
+
+  template<typename Key>
+  bool contains(const Key& key) const { return findIndex(key) != ctrl.size(); }
+
+
+  std::pair<iterator, bool> insert(const Value& value) { return emplace(value); }
+  std::pair<iterator, bool> insert(Value&& value) { return emplace(std::move(value)); }
+
+  // Constructs the value first to get its key, so prefer Map::try_emplace to avoid constructing existing values
+  template<typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    Value value(std::forward<Args>(args)...);
+    return insertKey(KeyOf()(value), [&](void* slot) { ::new (slot) Value(std::move(value)); });
+  }
+
+protected:
+  // Inserts the value created by construct(slot) if no value with the given key exists
+  template<typename Key, typename Construct>
+  std::pair<iterator, bool> insertKey(const Key& key, Construct&& construct) {
+    auto hash = Hash()(key);
+    if (auto index = findIndex(key, hash); index != ctrl.size()) {
+      return { iterator(this, index), false };
+    }
+
+    if ((count + 1) * 8 > ctrl.size() * 7) { // max load factor 7/8
+      rehash(std::max(detail::GroupSize, 2 * ctrl.size()));
+    }
+    auto index = findEmpty(hash);
+    construct(&slots[index].value);
+    ctrl[index] = control(hash);
+    ++count;
+    return { iterator(this, index), true };
+  }
+
+private:
+  union Slot {
+    Slot() {}
+    ~Slot() {}
+    Value value;
+  };
+
+  static int8_t control(size_t hash) { return static_cast<int8_t>(hash & 0x7f); }
+  size_t firstGroup(size_t hash) const { return (hash >> 7) & (ctrl.size() / detail::GroupSize - 1); }
+
+  template<typename Key>
+  size_t findIndex(const Key& key) const {
+    return ctrl.empty() ? 0 : findIndex(key, Hash()(key));
+  }
+
+  // Returns the index of the value with the given key or ctrl.size() if it doesn't exist
+  template<typename Key>
+  size_t findIndex(const Key& key, size_t hash) const {
+    if (ctrl.empty()) {
+      return 0;
+    }
+
+    auto groupMask = ctrl.size() / detail::GroupSize - 1;
+    // Triangular probing visits every group once, since the number of groups is a power of two
+    for (size_t group = firstGroup(hash), step = 1;; group = (group + step++) & groupMask) {
+      detail::Group controls(&ctrl[group * detail::GroupSize]);
+      for (auto matches = controls.match(control(hash)); matches; matches &= matches - 1) {
+        auto index = group * detail::GroupSize + std::countr_zero(matches);
+        if (KeyEqual()(KeyOf()(slots[index].value), key)) {
+          return index;
+        }
+      }
+      if (controls.match(detail::Empty)) {
+        return ctrl.size(); // the probe sequence would have inserted the key here
+      }
+    }
+  }
+
+  // Returns the first empty slot in the probe sequence of the hash (there must be one)
+  size_t findEmpty(size_t hash) const {
+    auto groupMask = ctrl.size() / detail::GroupSize - 1;
+    for (size_t group = firstGroup(hash), step = 1;; group = (group + step++) & groupMask) {
+      if (auto empty = detail::Group(&ctrl[group * detail::GroupSize]).match(detail::Empty)) {
+        return group * detail::GroupSize + std::countr_zero(empty);
+      }
+    }
+  }
+
+  void rehash(size_t newCapacity) {
+    auto oldCtrl = std::exchange(ctrl, std::vector<int8_t>(newCapacity, detail::Empty));
+    auto oldSlots = std::exchange(slots, std::make_unique<Slot[]>(newCapacity));
+    for (size_t i = 0; i < oldCtrl.size(); ++i) {
+      if (oldCtrl[i] != detail::Empty) {
+        auto& value = oldSlots[i].value;
+        auto hash = Hash()(KeyOf()(value));
+        auto index = findEmpty(hash);
+        ::new (&slots[index].value) Value(std::move(value));
+        ctrl[index] = control(hash);
+        std::destroy_at(&value);
+      }
+    }
+  }
+
+  std::vector<int8_t> ctrl; // control byte of each slot
+  std::unique_ptr<Slot[]> slots;
+  size_t count = 0;
+};
+
+
+template<typename Key, typename Hash = hashing::Hash<Key>, typename KeyEqual = std::equal_to<>>
+class Set : public Table<Key, Hash, KeyEqual, detail::Identity> {};
+
+
+template<typename Key, typename Value, typename Hash = hashing::Hash<Key>, typename KeyEqual = std::equal_to<>>
+class Map : public Table<std::pair<const Key, Value>, Hash, KeyEqual, detail::First> {
+public:
+  using Base = Table<std::pair<const Key, Value>, Hash, KeyEqual, detail::First>;
+
+  // Only constructs the value if the key doesn't exist yet
+  template<typename K, typename... Args>
+  std::pair<typename Base::iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return this->insertKey(key, [&](void* slot) {
+      ::new (slot) std::pair<const Key, Value>(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+    });
+  }
+
+  template<typename K>
+  Value& operator[](K&& key) {
+    return try_emplace(std::forward<K>(key)).first->second;
+  }
+};
+
+}
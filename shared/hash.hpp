@@ -0,0 +1,138 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/** Hash functions with a strong final mixing step. Open addressing tables (see flat_hash.hpp) use both the low and the
+ *  high bits of a hash, so the identity hash of std::hash<int> and simple combinations like h * 31 + x cluster badly there.
+ *
+ *  hashing::Hash<T> mixes integers, enums and pointers directly, hashes strings bytewise and combines the members
+ *  of pairs and tuples. All other types are hashed through std::hash<T> and then mixed.
+ */
+namespace hashing {
+
+// Finalizer with full avalanche (every input bit affects every output bit)
+constexpr uint64_t mix(uint64_t x) {
+  x ^= x >> 32;
+  x *= 0xd6e8feb86659fd93;
+  x ^= x >> 32;
+  x *= 0xd6e8feb86659fd93;
+  x ^= x >> 32;
+  return x;
+}
+
+inline uint64_t hashBytes(std::string_view bytes) {
+  uint64_t hash = mix(bytes.size());
+  auto pos = bytes.data(), end = pos + bytes.size();
+  for (; end - pos >= 8; pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, pos, 8);
+    hash = mix(hash ^ word);
+  }
+  if (pos != end) {
+    uint64_t word = 0;
+    std::memcpy(&word, pos, end - pos);
+    hash = mix(hash ^ word);
+  }
+  return hash;
+}
+
+/** Hash of bytes which arrive in pieces, e.g. the contents of a growing file. The hash doesn't depend on how the
+ *  bytes are split into pieces, but it differs from hashBytes() of the same bytes.
+ */
+class StreamHash {
+public:
+  void add(std::string_view bytes) {
+    size += bytes.size();
+    if (pendingSize) {
+      auto count = std::min(bytes.size(), 8 - pendingSize);
+      std::memcpy(pending + pendingSize, bytes.data(), count);
+      pendingSize += count;
+      bytes.remove_prefix(count);
+      if (pendingSize < 8) {
+        return;
+      }
+      addWord(pending);
+      pendingSize = 0;
+    }
+    for (; bytes.size() >= 8; bytes.remove_prefix(8)) {
+      addWord(bytes.data());
+    }
+    std::memcpy(pending, bytes.data(), bytes.size());
+    pendingSize = bytes.size();
+  }
+
+  uint64_t value() const {
+    uint64_t word = 0;
+    std::memcpy(&word, pending, pendingSize);
+    return mix(mix(state ^ word) ^ size);
+  }
+
+private:
+  void addWord(const char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, 8);
+    state = mix(state ^ word);
+  }
+
+  uint64_t state = 0;
+  uint64_t size = 0;
+  char pending[8] = {}; // the bytes of an incomplete word
+  size_t pendingSize = 0;
+};
+
+
+template<typename T>
+struct Hash {
+  size_t operator()(const T& value) const {
+    if constexpr (std::is_enum_v<T>) {
+      return static_cast<size_t>(mix(static_cast<uint64_t>(static_cast<std::underlying_type_t<T>>(value))));
+    } else if constexpr (std::is_integral_v<T>) {
+      return static_cast<size_t>(mix(static_cast<uint64_t>(value)));
+    } else if constexpr (std::is_pointer_v<T>) {
+      return static_cast<size_t>(mix(reinterpret_cast<uintptr_t>(value)));
+    } else {
+      return static_cast<size_t>(mix(std::hash<T>{}(value)));
+    }
+  }
+};
+
+// Transparent, so that tables of strings can be queried with string_views and vice versa
+template<>
+struct Hash<std::string_view> {
+  using is_transparent = void;
+  size_t operator()(std::string_view value) const { return static_cast<size_t>(hashBytes(value)); }
+};
+
+template<>
+struct Hash<std::string> : Hash<std::string_view> {};
+
+
+/** Stronger replacement for hash_all(): combines the hashes of all values
+ */
+template<typename... T>
+size_t combine(const T&... values) {
+  uint64_t hash = 0;
+  ((hash = mix(hash + 0x9e3779b97f4a7c15 + Hash<T>{}(values))), ...);
+  return static_cast<size_t>(hash);
+}
+
+template<typename A, typename B>
+struct Hash<std::pair<A, B>> {
+  size_t operator()(const std::pair<A, B>& value) const { return combine(value.first, value.second); }
+};
+
+template<typename... T>
+struct Hash<std::tuple<T...>> {
+  size_t operator()(const std::tuple<T...>& value) const {
+    return std::apply([](const T&... values) { return combine(values...); }, value);
+  }
+};
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lines.hpp"
+
+namespace text {
+
+/** Reads a stream (e.g. std::cin fed by a decompressor) on a background thread into a ring of buffers, so that reading
+ *  the input overlaps with parsing it. This is meant for pipes, which cannot be memory mapped.
+ *
+ *  Each buffer is handed out as a Block of complete lines (a line is never split across two blocks):
+ *
+ *    text::LineReader reader(std::cin);
+ *    while (auto block = reader.next()) {
+ *      for (auto line : block->lines()) { ... }
+ *    } // the string_views of a block stay valid until the block is destroyed, which returns its buffer to the reader
+ *
+ *  Buffers grow if a single line doesn't fit into one. Errors of the reading thread are rethrown by next().
+ */
+class LineReader {
+public:
+  class Block {
+  public:
+    Block(LineReader& reader, size_t index, size_t size) : reader(&reader), index(index), size(size) {}
+    Block(Block&& other) noexcept : reader(std::exchange(other.reader, nullptr)), index(other.index), size(other.size) {}
+    Block& operator=(Block&&) = delete;
+    ~Block() {
+      if (reader) {
+        reader->release(index);
+      }
+    }
+
+    std::string_view text() const { return std::string_view(reader->buffers[index].data(), size); }
+    Lines lines() const { return Lines(text()); }
+
+  private:
+    LineReader* reader;
+    size_t index; // of the buffer
+    size_t size;  // used bytes of the buffer
+  };
+
+
+  LineReader(std::istream& input, size_t blockSize = 1 << 18, size_t blockCount = 4) : input(input), buffers(blockCount) {
+    for (size_t i = 0; i < blockCount; ++i) {
+      buffers[i].resize(blockSize);
+      freeBuffers.push_back(i);
+    }
+    thread = std::thread([this] { readAll(); });
+  }
+
+  LineReader(const LineReader&) = delete;
+  LineReader& operator=(const LineReader&) = delete;
+
+  // All blocks must have been destroyed before the reader
+  ~LineReader() {
+    {
+      std::lock_guard lock(mutex);
+      stopped = true;
+    }
+    changed.notify_all();
+    thread.join();
+  }
+
+  // Returns the next block or nullopt at the end of the input
+  std::optional<Block> next() {
+    std::unique_lock lock(mutex);
+    changed.wait(lock, [&] { return !filledBuffers.empty() || finished; });
+    if (filledBuffers.empty()) {
+      if (error) {
+        std::rethrow_exception(std::exchange(error, nullptr));
+      }
+      return std::nullopt;
+    }
+
+    auto [index, size] = filledBuffers.front();
+    filledBuffers.pop_front();
+    return Block(*this, index, size);
+  }
+
+private:
+  void release(size_t index) {
+    {
+      std::lock_guard lock(mutex);
+      freeBuffers.push_back(index);
+    }
+    changed.notify_all();
+  }
+
+  // Runs on the reading thread
+  void readAll() {
+    try {
+      std::string carry; // incomplete last line of the previous block
+      bool eof = false;
+      while (!eof) {
+        size_t index;
+        {
+          std::unique_lock lock(mutex);
+          changed.wait(lock, [&] { return !freeBuffers.empty() || stopped; });
+          if (stopped) {
+            break;
+          }
+          index = freeBuffers.front();
+          freeBuffers.pop_front();
+        }
+
+        // The buffer belongs to this thread until it is published
+        auto& buffer = buffers[index];
+        if (buffer.size() < 2 * carry.size()) {
+          buffer.resize(2 * carry.size());
+        }
+        std::memcpy(buffer.data(), carry.data(), carry.size());
+        size_t used = carry.size();
+        size_t blockEnd = 0; // end of the last complete line
+        for (;;) {
+          input.read(buffer.data() + used, buffer.size() - used);
+          auto count = static_cast<size_t>(input.gcount());
+          if (auto newline = std::string_view(buffer.data() + used, count).rfind('\n'); newline != std::string_view::npos) {
+            blockEnd = used + newline + 1;
+          }
+          used += count;
+
+          if (!input) {
+            eof = true;
+            blockEnd = used; // the remainder is the last line
+            break;
+          } else if (blockEnd) {
+            break;
+          }
+          buffer.resize(2 * buffer.size()); // the line doesn't fit
+        }
+        carry.assign(buffer.data() + blockEnd, used - blockEnd);
+
+        {
+          std::lock_guard lock(mutex);
+          if (blockEnd) {
+            filledBuffers.emplace_back(index, blockEnd);
+          } else {
+            freeBuffers.push_back(index); // nothing left to hand out
+          }
+        }
+        changed.notify_all();
+      }
+    } catch (...) {
+      std::lock_guard lock(mutex);
+      error = std::current_exception();
+    }
+
+    {
+      std::lock_guard lock(mutex);
+      finished = true;
+    }
+    changed.notify_all();
+  }
+
+  std::istream& input;
+  std::vector<std::string> buffers;
+
+  std::mutex mutex; // guards all of the following
+  std::condition_variable changed;
+  std::deque<size_t> freeBuffers;
+  std::deque<std::pair<size_t, size_t>> filledBuffers; // buffer index and used size in reading order
+  std::exception_ptr error;
+  bool finished = false;
+  bool stopped = false;
+
+  std::thread thread; // started at the end of the constructor
+};
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+namespace text {
+
+/** View over the lines of a text, which yields string_views into the text instead of copying each line.
+ *  Splits like std::getline: a trailing newline doesn't produce an additional empty line.
+ *  A '\r' before the newline is stripped, so CRLF inputs produce the same lines on all platforms.
+ */
+class Lines : public std::ranges::view_interface<Lines> {
+public:
+  class Iterator {
+  public:
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(std::string_view rest) : rest(rest) { advance(); }
+
+    std::string_view operator*() const { return line; }
+
+    Iterator& operator++() {
+      advance();
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto copy = *this;
+      advance();
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return atEnd == other.atEnd && rest.data() == other.rest.data(); }
+    bool operator==(std::default_sentinel_t) const { return atEnd; }
+
+  private:
+    void advance() {
+      if (rest.empty()) {
+        atEnd = true;
+        line = {};
+        return;
+      }
+
+      auto pos = rest.find('\n');
+      line = rest.substr(0, pos);
+      rest.remove_prefix(pos == std::string_view::npos ? rest.size() : pos + 1);
+      if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+      }
+    }
+
+    std::string_view rest;
+    std::string_view line;
+    bool atEnd = false;
+  };
+
+  Lines() = default;
+  Lines(std::string_view text) : text(text) {}
+
+  Iterator begin() const { return Iterator(text); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+  std::string_view text;
+};
+
+inline Lines lines(std::string_view text) { return Lines(text); }
+
+}
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<text::Lines> = true;
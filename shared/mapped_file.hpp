@@ -0,0 +1,89 @@
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // projects may define it already
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/** Read-only memory mapping of a whole file, which exposes its content as one string_view without copying it.
+ *  Throws std::runtime_error if the file cannot be opened or mapped.
+ */
+struct MappedFile {
+  MappedFile(const std::string& path) {
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+      throw std::runtime_error("Failed to open " + path);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+      CloseHandle(file);
+      throw std::runtime_error("Failed to open " + path);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size) {
+      mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      data = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    }
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open " + path);
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+      close(fd);
+      throw std::runtime_error("Failed to open " + path);
+    }
+    size = static_cast<size_t>(fileStat.st_size);
+    if (size) {
+      auto address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      data = (address != MAP_FAILED) ? static_cast<const char*>(address) : nullptr;
+      if (data) {
+        madvise(address, size, MADV_SEQUENTIAL); // the inputs are parsed front to back, so read ahead aggressively
+      }
+    }
+    close(fd); // the mapping stays valid without the descriptor
+#endif
+    if (size && !data) {
+#ifdef _WIN32
+      // The destructor doesn't run for a throwing constructor
+      if (mapping) CloseHandle(mapping);
+      CloseHandle(file);
+#endif
+      throw std::runtime_error("Failed to map " + path);
+    }
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+#else
+    if (data) munmap(const_cast<char*>(data), size);
+#endif
+  }
+
+  std::string_view view() const { return std::string_view(data, size); }
+
+  const char* data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = NULL;
+#endif
+};
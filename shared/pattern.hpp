@@ -0,0 +1,373 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+/** Line patterns, which are parsed at compile time into a specialized scanner with typed captures:
+ *
+ *    if (auto captures = pattern::match<"Card {int}: {ints} | {ints}">(line)) {
+ *      auto [id, winning, own] = *captures; // int64_t, pattern::Numbers, pattern::Numbers
+ *    }
+ *
+ *  Placeholders:
+ *    {int}   an optionally negative decimal number -> int64_t
+ *    {word}  one or more letters or digits         -> std::string_view
+ *    {ints}  zero or more space separated {int}    -> pattern::Numbers (lazy view of int64_t)
+ *    {rest}  everything up to the end of the text  -> std::string_view
+ *
+ *  A space in the pattern matches one or more spaces, all other characters match themselves.
+ *  The string_view captures point into the scanned text. Nothing is allocated.
+ */
+namespace pattern {
+
+template<size_t N>
+struct String {
+  constexpr String(const char (&str)[N]) { std::copy_n(str, N, data); }
+  constexpr std::string_view view() const { return std::string_view(data, N - 1); }
+
+  char data[N];
+};
+
+
+/** Space separated numbers of an {ints} capture, which are only parsed when iterating them
+ */
+class Numbers : public std::ranges::view_interface<Numbers> {
+public:
+  class Iterator {
+  public:
+    using value_type = int64_t;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(const char* pos, const char* end) : pos(pos), end(end) { advance(); }
+
+    int64_t operator*() const { return value; }
+
+    Iterator& operator++() {
+      advance();
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto copy = *this;
+      advance();
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return atEnd == other.atEnd && pos == other.pos; }
+    bool operator==(std::default_sentinel_t) const { return atEnd; }
+
+  private:
+    void advance();
+
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    int64_t value = 0;
+    bool atEnd = false;
+  };
+
+  Numbers() = default;
+  Numbers(std::string_view text) : text(text) {}
+
+  Iterator begin() const { return Iterator(text.data(), text.data() + text.size()); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  std::string_view text;
+};
+
+
+namespace detail {
+  enum class Kind { Literal, Spaces, Int, Word, Ints, Rest };
+
+  struct Token {
+    Kind kind = Kind::Literal;
+    size_t begin = 0;  // of a literal in the pattern
+    size_t length = 0;
+  };
+
+  constexpr std::pair<std::string_view, Kind> placeholders[] = {
+    { "{int}", Kind::Int },
+    { "{word}", Kind::Word },
+    { "{ints}", Kind::Ints },
+    { "{rest}", Kind::Rest },
+  };
+
+  // Splits the pattern into tokens and returns their number (tokens may be nullptr to only count them)
+  constexpr size_t tokenize(std::string_view pattern, Token* tokens) {
+    size_t count = 0;
+    auto add = [&](Token token) {
+      if (tokens) {
+        tokens[count] = token;
+      }
+      ++count;
+    };
+
+    for (size_t pos = 0; pos < pattern.size();) {
+      if (pattern[pos] == '{') {
+        auto placeholder = std::ranges::find_if(placeholders, [&](auto& entry) { return pattern.substr(pos).starts_with(entry.first); });
+        if (placeholder == std::end(placeholders)) {
+          throw "Unknown placeholder in pattern"; // not a constant expression -> compile error
+        }
+        add(Token { .kind = placeholder->second });
+        pos += placeholder->first.size();
+      } else if (pattern[pos] == ' ') {
+        while (pos < pattern.size() && pattern[pos] == ' ') {
+          ++pos;
+        }
+        add(Token { .kind = Kind::Spaces });
+      } else {
+        auto begin = pos;
+        while (pos < pattern.size() && pattern[pos] != '{' && pattern[pos] != ' ') {
+          ++pos;
+        }
+        add(Token { .kind = Kind::Literal, .begin = begin, .length = pos - begin });
+      }
+    }
+    return count;
+  }
+
+  constexpr bool isCapture(Kind kind) { return kind != Kind::Literal && kind != Kind::Spaces; }
+
+  template<String P>
+  constexpr auto tokens = [] {
+    std::array<Token, tokenize(P.view(), nullptr)> result;
+    tokenize(P.view(), result.data());
+    return result;
+  }();
+
+  // Index of the capture of each token
+  template<String P>
+  constexpr auto captureIndices = [] {
+    std::array<size_t, tokens<P>.size()> result = {};
+    size_t captures = 0;
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] = captures;
+      captures += isCapture(tokens<P>[i].kind);
+    }
+    return result;
+  }();
+
+  // Token index of each capture
+  template<String P>
+  constexpr auto captureTokens = [] {
+    std::array<size_t, std::ranges::count_if(tokens<P>, [](const Token& token) { return isCapture(token.kind); })> result = {};
+    for (size_t i = 0, capture = 0; i < tokens<P>.size(); ++i) {
+      if (isCapture(tokens<P>[i].kind)) {
+        result[capture++] = i;
+      }
+    }
+    return result;
+  }();
+
+  template<Kind K> struct CaptureType;
+  template<> struct CaptureType<Kind::Int> { using type = int64_t; };
+  template<> struct CaptureType<Kind::Word> { using type = std::string_view; };
+  template<> struct CaptureType<Kind::Ints> { using type = Numbers; };
+  template<> struct CaptureType<Kind::Rest> { using type = std::string_view; };
+
+  template<String P, size_t... I>
+  auto capturesType(std::index_sequence<I...>) -> std::tuple<typename CaptureType<tokens<P>[captureTokens<P>[I]].kind>::type...>;
+
+
+  inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+  inline bool isAlnum(char c) { return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+  inline bool scanInt(const char*& pos, const char* end, int64_t& value) {
+    auto start = pos;
+    bool negative = (pos != end && *pos == '-');
+    if (negative) {
+      ++pos;
+    }
+    if (pos == end || !isDigit(*pos)) {
+      pos = start;
+      return false;
+    }
+
+    value = 0;
+    for (; pos != end && isDigit(*pos); ++pos) {
+      value = value * 10 + (*pos - '0');
+    }
+    if (negative) {
+      value = -value;
+    }
+    return true;
+  }
+
+  // Skips spaces followed by another number, but leaves trailing spaces for the following token
+  inline void scanInts(const char*& pos, const char* end) {
+    int64_t value;
+    for (auto next = pos;; pos = next) {
+      while (next != end && *next == ' ') {
+        ++next;
+      }
+      if (!scanInt(next, end, value)) {
+        return;
+      }
+    }
+  }
+}
+
+template<String P>
+using Captures = decltype(detail::capturesType<P>(std::make_index_sequence<detail::captureTokens<P>.size()>()));
+
+
+namespace detail {
+  template<String P, size_t I>
+  bool scanToken(const char*& pos, const char* end, Captures<P>& captures) {
+    constexpr Token token = tokens<P>[I];
+    if constexpr (token.kind == Kind::Literal) {
+      constexpr auto literal = P.view().substr(token.begin, token.length);
+      if (static_cast<size_t>(end - pos) < literal.size() || std::string_view(pos, literal.size()) != literal) {
+        return false;
+      }
+      pos += literal.size();
+      return true;
+    } else if constexpr (token.kind == Kind::Spaces) {
+      if (pos == end || *pos != ' ') {
+        return false;
+      }
+      while (pos != end && *pos == ' ') {
+        ++pos;
+      }
+      return true;
+    } else {
+      auto& capture = std::get<captureIndices<P>[I]>(captures);
+      auto begin = pos;
+      if constexpr (token.kind == Kind::Int) {
+        return scanInt(pos, end, capture);
+      } else if constexpr (token.kind == Kind::Word) {
+        while (pos != end && isAlnum(*pos)) {
+          ++pos;
+        }
+        capture = std::string_view(begin, pos - begin);
+        return pos != begin;
+      } else if constexpr (token.kind == Kind::Ints) {
+        scanInts(pos, end);
+        capture = Numbers(std::string_view(begin, pos - begin));
+        return true;
+      } else { // Rest
+        pos = end;
+        capture = std::string_view(begin, end - begin);
+        return true;
+      }
+    }
+  }
+
+  template<String P, size_t... I>
+  bool scan(const char*& pos, const char* end, Captures<P>& captures, std::index_sequence<I...>) {
+    return (scanToken<P, I>(pos, end, captures) && ...);
+  }
+
+  template<String P>
+  bool scan(const char*& pos, const char* end, Captures<P>& captures) {
+    return scan<P>(pos, end, captures, std::make_index_sequence<tokens<P>.size()>());
+  }
+}
+
+
+/** Matches the whole text against the pattern
+ */
+template<String P>
+std::optional<Captures<P>> match(std::string_view text) {
+  Captures<P> captures;
+  auto pos = text.data(), end = text.data() + text.size();
+  if (detail::scan<P>(pos, end, captures) && pos == end) {
+    return captures;
+  }
+  return std::nullopt;
+}
+
+
+/** Matches the pattern at the beginning of the text and removes the matched part from it
+ */
+template<String P>
+std::optional<Captures<P>> matchPrefix(std::string_view& text) {
+  Captures<P> captures;
+  auto pos = text.data(), end = text.data() + text.size();
+  if (detail::scan<P>(pos, end, captures)) {
+    text.remove_prefix(pos - text.data());
+    return captures;
+  }
+  return std::nullopt;
+}
+
+
+/** View of the captures of all non-overlapping matches of the pattern in the text from left to right
+ */
+template<String P>
+class Matches : public std::ranges::view_interface<Matches<P>> {
+public:
+  class Iterator {
+  public:
+    using value_type = Captures<P>;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() = default;
+    Iterator(std::string_view rest) : rest(rest) { advance(); }
+
+    const Captures<P>& operator*() const { return *captures; }
+
+    Iterator& operator++() {
+      advance();
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto copy = *this;
+      advance();
+      return copy;
+    }
+
+    bool operator==(const Iterator& other) const { return captures.has_value() == other.captures.has_value() && rest.data() == other.rest.data(); }
+    bool operator==(std::default_sentinel_t) const { return !captures; }
+
+  private:
+    void advance() {
+      if (emptyMatch && !rest.empty()) {
+        rest.remove_prefix(1); // otherwise the same empty match would be found forever
+      }
+      for (; !rest.empty(); rest.remove_prefix(1)) {
+        auto start = rest.data();
+        if ((captures = matchPrefix<P>(rest))) {
+          emptyMatch = rest.data() == start;
+          return;
+        }
+      }
+      captures.reset();
+    }
+
+    std::string_view rest;
+    std::optional<Captures<P>> captures;
+    bool emptyMatch = false; // the current match consumed nothing
+  };
+
+  Matches() = default;
+  Matches(std::string_view text) : text(text) {}
+
+  Iterator begin() const { return Iterator(text); }
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+  std::string_view text;
+};
+
+template<String P>
+Matches<P> iter(std::string_view text) { return Matches<P>(text); }
+
+
+inline void Numbers::Iterator::advance() {
+  while (pos != end && *pos == ' ') {
+    ++pos;
+  }
+  atEnd = !detail::scanInt(pos, end, value);
+}
+
+}
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<pattern::Numbers> = true;
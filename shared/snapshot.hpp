@@ -0,0 +1,204 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "hash.hpp"
+#include "mapped_file.hpp"
+
+/** Binary snapshots of the parsed state of a day, which replace parsing the text input on later runs:
+ *
+ *    snapshot::Writer writer;
+ *    writer.tag("day05/1");            // the layout of the payload, bumped whenever it changes
+ *    writer.array(seeds);
+ *    writer.save("input.txt.snapshot", input);
+ *
+ *    snapshot::File file("input.txt.snapshot");
+ *    if (file.matches(input)) {
+ *      auto reader = file.reader();
+ *      if (reader.tag("day05/1")) {
+ *        seeds = reader.array<int64_t>(); // a span into the mapped file
+ *      }
+ *    }
+ *
+ *  A snapshot is a header followed by the payload of values, arrays and strings of trivially copyable types in native
+ *  byte order. The header records the format version, the size and checksum of the input it was written for and the
+ *  checksum of the payload, so a snapshot of another input, an older format or a damaged file is never used.
+ *  The file is memory mapped and arrays are returned as spans into it (aligned like their type), so the snapshot
+ *  must outlive everything loaded from it.
+ */
+namespace snapshot {
+
+inline constexpr std::array<char, 8> Magic = { 'A', 'O', 'C', 'S', 'N', 'A', 'P', '\0' };
+inline constexpr uint32_t FormatVersion = 1;
+
+inline uint64_t checksum(std::string_view data) {
+  return hashing::hashBytes(data);
+}
+
+struct Header {
+  std::array<char, 8> magic = Magic;
+  uint32_t version = FormatVersion;
+  uint32_t reserved = 0;
+  uint64_t inputSize = 0;
+  uint64_t inputChecksum = 0;
+  uint64_t payloadSize = 0;
+  uint64_t payloadChecksum = 0;
+  uint64_t padding[2] = {}; // the payload starts 64 byte aligned in the mapping
+};
+
+static_assert(sizeof(Header) == 64);
+
+
+class Writer {
+public:
+  template<typename T>
+  void value(const T& value) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    append(&value, sizeof(T), alignof(T));
+  }
+
+  // Any contiguous range of a trivially copyable type, written with its size
+  template<std::ranges::contiguous_range Range>
+  void array(const Range& values) {
+    using T = std::ranges::range_value_t<Range>;
+    static_assert(std::is_trivially_copyable_v<T>);
+    value<uint64_t>(std::ranges::size(values));
+    append(std::ranges::data(values), std::ranges::size(values) * sizeof(T), alignof(T));
+  }
+
+  void string(std::string_view text) {
+    value<uint64_t>(text.size());
+    append(text.data(), text.size(), 1);
+  }
+
+  // Identifies the content and layout of the payload
+  void tag(std::string_view name) { string(name); }
+
+  std::string_view payload() const { return buffer; }
+
+  /** Writes the snapshot for the given input. It is written to a temporary file first and then renamed, so that
+   *  concurrent readers never see a partial snapshot. Throws std::runtime_error if writing fails.
+   */
+  void save(const std::string& path, std::string_view input) const {
+    Header header;
+    header.inputSize = input.size();
+    header.inputChecksum = checksum(input);
+    header.payloadSize = buffer.size();
+    header.payloadChecksum = checksum(buffer);
+
+    auto temporary = path + ".tmp";
+    {
+      std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(buffer.data(), buffer.size());
+      if (!out.flush()) {
+        throw std::runtime_error("Failed to write " + temporary);
+      }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+      throw std::runtime_error("Failed to write " + path + ": " + error.message());
+    }
+  }
+
+private:
+  void append(const void* data, size_t size, size_t alignment) {
+    buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, '\0');
+    buffer.append(static_cast<const char*>(data), size);
+  }
+
+  std::string buffer;
+};
+
+
+/** Reads the payload in the order it was written. Throws std::runtime_error when reading past its end.
+ */
+class Reader {
+public:
+  explicit Reader(std::string_view payload) : payload(payload) {}
+
+  template<typename T>
+  T value() {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>);
+    T result;
+    std::memcpy(&result, take(1, sizeof(T), alignof(T)), sizeof(T));
+    return result;
+  }
+
+  template<typename T>
+  std::span<const T> array() {
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto count = value<uint64_t>();
+    auto data = take(count, sizeof(T), alignof(T));
+    return std::span<const T>(reinterpret_cast<const T*>(data), static_cast<size_t>(count));
+  }
+
+  std::string_view string() {
+    auto size = value<uint64_t>();
+    return std::string_view(take(size, 1, 1), static_cast<size_t>(size));
+  }
+
+  // True if the next tag is the given one, i.e. the payload has the expected layout
+  bool tag(std::string_view name) { return string() == name; }
+
+private:
+  const char* take(uint64_t count, size_t size, size_t alignment) {
+    position = (position + alignment - 1) / alignment * alignment;
+    if (position > payload.size() || count > (payload.size() - position) / size) {
+      throw std::runtime_error("Truncated snapshot");
+    }
+    auto data = payload.data() + position;
+    position += static_cast<size_t>(count) * size;
+    return data;
+  }
+
+  std::string_view payload;
+  size_t position = 0;
+};
+
+
+/** A memory mapped snapshot. Throws std::runtime_error if the file cannot be opened.
+ */
+class File {
+public:
+  File(const std::string& path) : mapped(path) {}
+
+  // True if the snapshot is complete, has the current format and was written for exactly this input
+  bool matches(std::string_view input) const {
+    auto data = mapped.view();
+    if (data.size() < sizeof(Header)) {
+      return false;
+    }
+    Header header;
+    std::memcpy(&header, data.data(), sizeof(Header));
+    return header.magic == Magic && header.version == FormatVersion
+      && header.payloadSize == payload().size() && header.inputSize == input.size()
+      && header.payloadChecksum == checksum(payload()) && header.inputChecksum == checksum(input);
+  }
+
+  // @pre matches() for the input
+  Reader reader() const { return Reader(payload()); }
+
+private:
+  std::string_view payload() const {
+    auto data = mapped.view();
+    return data.substr(std::min(data.size(), sizeof(Header)));
+  }
+
+  MappedFile mapped;
+};
+
+}
@@ -0,0 +1,319 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <common/time.hpp>
+#include <common/task.hpp>
+
+#include "mapped_file.hpp"
+#include "snapshot.hpp"
+#include "timing.hpp"
+
+#ifndef AOC_DRIVER
+#include "allocation_hooks.hpp" // the standalone day executables consist of only one translation unit
+#endif
+
+/** The results of both parts of a day (all days so far have integer results)
+ */
+struct Answer {
+  int64_t part1 = 0;
+  int64_t part2 = 0;
+
+  bool operator==(const Answer&) const = default;
+};
+
+
+/** Common interface of all days, which splits each solution into parsing the input and solving both parts.
+ *  The input passed to parse() must outlive the solver, so that it may keep string_views into it.
+ *  solve() doesn't modify the parsed state, so it can be called repeatedly to time it in isolation.
+ */
+struct Solver {
+  virtual ~Solver() = default;
+
+  virtual void parse(std::string_view input) = 0;
+  virtual Answer solve() const = 0;
+
+  /** Optional binary snapshot of the parsed state (see snapshot.hpp). save() returns false if the day has no snapshot.
+   *  load() replaces parse(), it may keep spans into the snapshot (which outlives the solver like the input) and
+   *  returns false if the snapshot has another layout. A solver must be parsed again after a failed load().
+   */
+  virtual bool save(snapshot::Writer&) const { return false; }
+  virtual bool load(snapshot::Reader&) { return false; }
+
+  // The number of threads solve() may use (0 for all hardware threads). solveFiles() limits each solver to one.
+  unsigned threads = 0;
+};
+
+
+namespace solver {
+  using Factory = std::function<std::unique_ptr<Solver>()>;
+
+  // All registered solvers by day
+  inline std::map<int, Factory>& registry() {
+    static std::map<int, Factory> solvers; // function local to not depend on the static initialization order
+    return solvers;
+  }
+
+  inline std::unique_ptr<Solver> create(int day) {
+    auto pos = registry().find(day);
+    return (pos != registry().end()) ? pos->second() : nullptr;
+  }
+
+
+  /** Registers the solver for the given day when declared as a static variable:
+   *    static solver::Registration<Solution> registration(5);
+   */
+  template<typename SolverT>
+  struct Registration {
+    Registration(int day) {
+      registry()[day] = [] { return std::unique_ptr<Solver>(std::make_unique<SolverT>()); };
+    }
+  };
+
+
+  // Reads the whole task input into memory
+  inline std::string readInput() {
+    auto input = task::input();
+    return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+  }
+
+
+  // The input file of the day. The day executables run in their project directory NN/, the inputs are in data/NN/.
+  inline std::string inputPath(int day) {
+    return std::format("../data/{:02d}/input.txt", day);
+  }
+
+
+  /** The task input as one string_view. The input file (see inputPath()) is memory mapped, so parsing reads directly
+   *  from the page cache. If it cannot be mapped, this is reported and the input is read through task::input() instead.
+   */
+  class Input {
+  public:
+    explicit Input(const std::string& path) {
+      try {
+        mapped.emplace(path);
+      } catch (const std::runtime_error& e) {
+        std::cerr << e.what() << ", reading the input through task::input() instead\n";
+        text = readInput();
+      }
+    }
+
+    std::string_view view() const { return mapped ? mapped->view() : std::string_view(text); }
+
+  private:
+    std::optional<MappedFile> mapped;
+    std::string text;
+  };
+
+
+  // The outcome of solving one file of a batch
+  struct FileResult {
+    std::string path;
+    std::optional<Answer> answer;
+    std::string error; // if there is no answer
+  };
+
+
+  // Replaces each directory by the regular files directly in it (in sorted order), files are kept as given
+  inline std::vector<std::string> expandPaths(const std::vector<std::string>& paths) {
+    std::vector<std::string> files;
+    for (auto& path : paths) {
+      if (!std::filesystem::is_directory(path)) {
+        files.push_back(path);
+        continue;
+      }
+      std::vector<std::string> contained;
+      for (auto& entry : std::filesystem::directory_iterator(path)) {
+        if (entry.is_regular_file()) {
+          contained.push_back(entry.path().string());
+        }
+      }
+      std::ranges::sort(contained);
+      files.insert(files.end(), contained.begin(), contained.end());
+    }
+    return files;
+  }
+
+
+  /** Solves each file with its own solver from the factory on a pool of threads, which take the next unsolved file
+   *  until none is left. Each input is memory mapped only while its file is solved. The process wide state (the 
+   *  registry, constant tables of the days) is shared by all threads, so it is initialized only once per batch.
+   *  Errors are recorded per file and don't stop the other files. The results are in the order of the files.
+   *  The files are already solved in parallel, so each solver runs on its own thread only.
+   */
+  inline std::vector<FileResult> solveFiles(const std::vector<std::string>& files, const Factory& factory, unsigned threads) {
+    std::vector<FileResult> results(files.size());
+    std::atomic<size_t> next = 0;
+    auto work = [&] {
+      for (size_t i = next++; i < files.size(); i = next++) {
+        auto& result = results[i];
+        result.path = files[i];
+        try {
+          MappedFile input(files[i]); // must outlive the solver
+          auto solver = factory();
+          solver->threads = 1;
+          solver->parse(input.view());
+          result.answer = solver->solve();
+        } catch (const std::exception& e) {
+          result.error = e.what();
+        }
+      }
+    };
+
+    threads = std::clamp<unsigned>(threads, 1, static_cast<unsigned>(std::max<size_t>(files.size(), 1)));
+    std::vector<std::jthread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+      pool.emplace_back(work);
+    }
+    work(); // the calling thread works as well
+    pool.clear(); // joins
+    return results;
+  }
+
+
+  /** Batch mode of the standalone day executables:
+   *
+   *    03 --batch [--threads N] PATH...
+   *
+   *  Solves every file given (or contained in a given directory) in one process and prints one line per file in the
+   *  order of the paths. Uses all hardware threads unless --threads is given. Returns 1 if any file failed.
+   */
+  inline int batchMain(const Factory& factory, int argc, char* argv[]) {
+    common::Time t;
+    auto usage = [&] {
+      std::cerr << "Usage: " << argv[0] << " --batch [--threads N] FILE_OR_DIRECTORY...\n";
+      return 1;
+    };
+
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+      std::string_view arg = argv[i];
+      if (arg == "--batch") {
+        continue;
+      } else if (arg == "--threads" && i + 1 < argc) {
+        try {
+          threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } catch (const std::logic_error&) { // std::invalid_argument or std::out_of_range
+          return usage();
+        }
+      } else {
+        paths.emplace_back(arg);
+      }
+    }
+    if (paths.empty()) {
+      return usage();
+    }
+
+    auto files = expandPaths(paths);
+    int failed = 0;
+    for (auto& result : solveFiles(files, factory, threads)) {
+      if (result.answer) {
+        std::cout << result.path << ": Part 1: " << result.answer->part1 << ", Part 2: " << result.answer->part2 << "\n";
+      } else {
+        std::cout << result.path << ": Error: " << result.error << "\n";
+        ++failed;
+      }
+    }
+    std::cout << files.size() << " files on " << std::min<size_t>(threads, files.size()) << " threads, ";
+    std::cout << t;
+    return failed ? 1 : 0;
+  }
+
+
+  /** Loads the solver from the snapshot at path if it exists and was written for this input. The snapshot is mapped
+   *  into file, which must outlive the solver. Returns false if the solver has to be parsed instead.
+   */
+  inline bool loadSnapshot(Solver& solver, std::string_view input, const std::string& path, std::optional<snapshot::File>& file) {
+    try {
+      file.emplace(path);
+      if (file->matches(input)) {
+        auto reader = file->reader();
+        if (solver.load(reader)) {
+          return true;
+        }
+      }
+    } catch (const std::runtime_error&) {
+      // missing or truncated, so it is replaced
+    }
+    file.reset();
+    return false;
+  }
+
+  // Writes the snapshot of a parsed solver, if it supports snapshots. Failing to write it is not an error.
+  inline void saveSnapshot(const Solver& solver, std::string_view input, const std::string& path) {
+    snapshot::Writer writer;
+    if (!solver.save(writer)) {
+      return;
+    }
+    try {
+      writer.save(path, input);
+    } catch (const std::runtime_error& e) {
+      std::cerr << e.what() << "\n";
+    }
+  }
+
+
+  /** The main() of the standalone day executables: solves the input of the day and prints the results in the usual
+   *  format. With AOC_TIMERS defined the phase timer tree is printed afterwards. With --batch as first argument the
+   *  files given on the command line are solved instead (see batchMain()).
+   *
+   *  With --snapshot the parsed state is loaded from input.txt.snapshot next to the input instead of parsing the
+   *  input, if the day supports snapshots and the snapshot belongs to the current input. Otherwise the input is 
+   *  parsed and the snapshot is (re)written for the next run.
+   */
+  template<typename SolverT>
+  int main(int day, int argc = 0, char* argv[] = nullptr) {
+    if (argc > 1 && std::string_view(argv[1]) == "--batch") {
+      return batchMain([] { return std::unique_ptr<Solver>(std::make_unique<SolverT>()); }, argc, argv);
+    }
+    bool useSnapshot = argc > 1 && std::string_view(argv[1]) == "--snapshot";
+    const std::string inputFile = inputPath(day);
+    const std::string snapshotPath = inputFile + ".snapshot";
+
+    common::Time t;
+
+    std::optional<Input> input; // must outlive the solver
+    std::optional<snapshot::File> snapshotFile; // as well, if the solver was loaded from it
+    SolverT solver;
+    Answer answer;
+    {
+      timing::Scope timer("read");
+      input.emplace(inputFile);
+      if (useSnapshot) {
+        timer.next("load snapshot");
+      }
+      if (!useSnapshot || !loadSnapshot(solver, input->view(), snapshotPath, snapshotFile)) {
+        timer.next("parse");
+        solver.parse(input->view());
+        if (useSnapshot) {
+          timer.next("save snapshot");
+          saveSnapshot(solver, input->view(), snapshotPath);
+        }
+      }
+      timer.next("solve");
+      answer = solver.solve();
+    }
+
+    std::cout << "Part 1: " << answer.part1 << "\n";
+    std::cout << "Part 2: " << answer.part2 << "\n";
+    std::cout << t;
+    timing::report(std::cout);
+    return 0;
+  }
+}
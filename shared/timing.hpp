@@ -0,0 +1,269 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "allocation.hpp"
+
+// The allocation statistics are reported per timing scope
+#if defined(AOC_ALLOC_STATS) && !defined(AOC_TIMERS)
+#define AOC_TIMERS
+#endif
+
+#if defined(AOC_TIMERS) && defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/** Nestable scoped phase timers, which aggregate into a tree per thread:
+ *
+ *    timing::Scope timer("part1");
+ *    ...
+ *    timer.next("part2"); // ends part1 and starts part2 as its sibling
+ *    ...
+ *    timing::report(std::cout);
+ *
+ *  Scopes with the same label under the same parent are merged and their calls are counted.
+ *  On Linux each scope additionally records cycles, instructions, cache misses and branch misses through 
+ *  perf_event_open() if the kernel permits it (see /proc/sys/kernel/perf_event_paranoid).
+ *
+ *  With AOC_ALLOC_STATS defined (which implies AOC_TIMERS) each scope also records the number of allocations,
+ *  the allocated bytes and the peak of live heap bytes of its thread.
+ *
+ *  The timers are only compiled in if AOC_TIMERS is defined. Otherwise Scope is an empty type and report() does nothing.
+ */
+namespace timing {
+
+#ifdef AOC_TIMERS
+
+constexpr bool enabled = true;
+
+enum Counter { Cycles, Instructions, CacheMisses, BranchMisses, CounterCount };
+using Counters = std::array<uint64_t, CounterCount>;
+
+
+#ifdef __linux__
+/** One perf event group for all counters of the calling thread, which is read at once
+ */
+class PerfCounters {
+public:
+  PerfCounters() {
+    const std::array<std::pair<uint32_t, uint64_t>, CounterCount> events = {{
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    }};
+
+    for (auto [type, config] : events) {
+      perf_event_attr attr = {};
+      attr.size = sizeof(attr);
+      attr.type = type;
+      attr.config = config;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1; // allows counting with perf_event_paranoid <= 2
+      attr.exclude_hv = 1;
+      int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, fds.empty() ? -1 : fds[0], 0));
+      if (fd < 0) {
+        close(); // either all counters or none
+        return;
+      }
+      fds.push_back(fd);
+    }
+  }
+
+  ~PerfCounters() { close(); }
+
+  bool available() const { return !fds.empty(); }
+
+  Counters read() const {
+    struct { uint64_t nr; uint64_t values[CounterCount]; } group = {};
+    Counters counters = {};
+    if (available() && ::read(fds[0], &group, sizeof(group)) == sizeof(group)) {
+      std::copy(std::begin(group.values), std::end(group.values), counters.begin());
+    }
+    return counters;
+  }
+
+private:
+  void close() {
+    for (auto fd : fds) {
+      ::close(fd);
+    }
+    fds.clear();
+  }
+
+  std::vector<int> fds;
+};
+#else
+// Hardware counters are only supported on Linux
+struct PerfCounters {
+  bool available() const { return false; }
+  Counters read() const { return {}; }
+};
+#endif
+
+
+struct Node {
+  Node(std::string label, Node* parent) : label(std::move(label)), parent(parent) {}
+
+  // Returns the child with the given label and creates it if necessary
+  Node& child(std::string_view childLabel) {
+    for (auto& node : children) {
+      if (node->label == childLabel) {
+        return *node;
+      }
+    }
+    return *children.emplace_back(std::make_unique<Node>(std::string(childLabel), this));
+  }
+
+  std::string label;
+  Node* parent;
+  std::vector<std::unique_ptr<Node>> children; // in order of their first call
+  size_t calls = 0;
+  std::chrono::nanoseconds time{};
+  Counters counters = {};
+  uint64_t allocations = 0;
+  uint64_t allocatedBytes = 0;
+  int64_t peakLiveBytes = 0;
+};
+
+
+struct ThreadState {
+  Node root { "total", nullptr };
+  Node* current = &root;
+  PerfCounters perf;
+};
+
+inline ThreadState& threadState() {
+  thread_local ThreadState state;
+  return state;
+}
+
+
+class Scope {
+public:
+  explicit Scope(std::string_view label) { start(label); }
+  ~Scope() { stop(); }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+  // Ends the current scope and starts a sibling scope with the given label
+  void next(std::string_view label) {
+    stop();
+    start(label);
+  }
+
+private:
+  void start(std::string_view label) {
+    auto& state = threadState();
+    node = &state.current->child(label);
+    state.current = node;
+    ++node->calls;
+    startCounters = state.perf.read();
+    startAllocations = allocation::counters;
+    allocation::counters.peak = allocation::counters.live; // track the peak of this scope, the outer peak is restored in stop()
+    startTime = std::chrono::steady_clock::now(); // last to not measure the counter read
+  }
+
+  void stop() {
+    auto stopTime = std::chrono::steady_clock::now();
+    auto& state = threadState();
+    auto stopCounters = state.perf.read();
+    auto& allocations = allocation::counters;
+    node->time += stopTime - startTime;
+    for (size_t i = 0; i < CounterCount; ++i) {
+      node->counters[i] += stopCounters[i] - startCounters[i];
+    }
+    node->allocations += allocations.allocations - startAllocations.allocations;
+    node->allocatedBytes += allocations.bytes - startAllocations.bytes;
+    node->peakLiveBytes = std::max(node->peakLiveBytes, allocations.peak);
+    allocations.peak = std::max(allocations.peak, startAllocations.peak);
+    state.current = node->parent;
+  }
+
+  Node* node = nullptr;
+  std::chrono::steady_clock::time_point startTime;
+  Counters startCounters = {};
+  allocation::Counters startAllocations;
+};
+
+
+inline void reportNode(std::ostream& out, const Node& node, std::chrono::nanoseconds parentTime, int depth, bool withCounters) {
+  auto ms = std::chrono::duration<double, std::milli>(node.time).count();
+  auto percent = parentTime.count() ? 100.0 * node.time.count() / parentTime.count() : 100.0;
+  auto label = std::string(depth * 2, ' ') + node.label;
+  out << std::format("{:<32} {:>8} {:>11.3f}ms {:>6.1f}%", label, node.calls, ms, percent);
+  if (withCounters) {
+    auto& c = node.counters;
+    auto ipc = c[Cycles] ? static_cast<double>(c[Instructions]) / c[Cycles] : 0.0;
+    out << std::format(" {:>14} {:>14} {:>5.2f} {:>12} {:>12}", c[Cycles], c[Instructions], ipc, c[CacheMisses], c[BranchMisses]);
+  }
+  if (allocation::enabled) {
+    out << std::format(" {:>10} {:>14} {:>14}", node.allocations, node.allocatedBytes, node.peakLiveBytes);
+  }
+  out << "\n";
+
+  for (auto& child : node.children) {
+    reportNode(out, *child, node.time, depth + 1, withCounters);
+  }
+}
+
+
+/** Prints the timer tree of the calling thread. All of its scopes must have ended.
+ */
+inline void report(std::ostream& out) {
+  auto& state = threadState();
+  auto& root = state.root;
+  root.calls = 1;
+  root.time = {};
+  root.counters = {};
+  root.allocations = root.allocatedBytes = 0;
+  root.peakLiveBytes = 0;
+  for (auto& child : root.children) {
+    root.time += child->time;
+    for (size_t i = 0; i < CounterCount; ++i) {
+      root.counters[i] += child->counters[i];
+    }
+    root.allocations += child->allocations;
+    root.allocatedBytes += child->allocatedBytes;
+    root.peakLiveBytes = std::max(root.peakLiveBytes, child->peakLiveBytes);
+  }
+
+  bool withCounters = state.perf.available();
+  out << std::format("\n{:<32} {:>8} {:>13} {:>7}", "scope", "calls", "time", "share");
+  if (withCounters) {
+    out << std::format(" {:>14} {:>14} {:>5} {:>12} {:>12}", "cycles", "instructions", "IPC", "cache misses", "branch misses");
+  }
+  if (allocation::enabled) {
+    out << std::format(" {:>10} {:>14} {:>14}", "allocs", "bytes", "peak live");
+  }
+  out << "\n";
+  reportNode(out, root, root.time, 0, withCounters);
+}
+
+#else
+
+constexpr bool enabled = false;
+
+// Compiled out: an empty scope, which the optimizer removes entirely
+struct Scope {
+  explicit Scope(std::string_view) {}
+  void next(std::string_view) {}
+};
+
+inline void report(std::ostream&) {}
+
+#endif
+
+}
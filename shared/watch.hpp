@@ -0,0 +1,362 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "flat_hash.hpp"
+#include "hash.hpp"
+#include "lines.hpp"
+#include "solver.hpp"
+
+/** Watch mode for days whose results are plain sums over independent lines: the sums of a file are updated whenever
+ *  it changes, evaluating only the lines which changed or were appended.
+ *
+ *    return watch::run(argv[2], [](std::string_view line) { return Answer { part1Of(line), part2Of(line) }; });
+ */
+namespace watch {
+
+// The contribution of one line to both sums
+using LineFunction = std::function<Answer(std::string_view line)>;
+
+
+/** The sums of the lines of a text, which is updated to a changed text with as few evaluated lines as possible.
+ *  Contributions are cached by the hash of their line. Empty lines contribute nothing.
+ */
+class LineSums {
+public:
+  explicit LineSums(LineFunction function) : function(std::move(function)) {}
+
+  /** Updates the sums to the current text and returns them.
+   *
+   *  If the text only grew behind the complete lines of the previous update (i.e. they hash to the same value),
+   *  only the appended lines are evaluated. Otherwise all lines are looked up by their hash, so only new or
+   *  changed lines are evaluated. An incomplete last line (e.g. one being written) is evaluated on each update
+   *  until it is complete. If a complete line throws, the state stays as it was before the update.
+   */
+  Answer update(std::string_view text) {
+    evaluatedLines = 0;
+    if (appended(text)) {
+      return extend(text.substr(consumed));
+    }
+
+    auto complete = text.substr(0, text.rfind('\n') + 1); // npos + 1 is 0
+    rescan(complete);
+    consumed = complete.size();
+    consumedHash = {};
+    consumedHash.add(complete);
+    incomplete = text.substr(consumed);
+    return total();
+  }
+
+  /** Updates the sums to the text of the previous update followed by bytes and returns them. Only the appended
+   *  lines are evaluated, the text of the previous update isn't needed again.
+   */
+  Answer append(std::string_view bytes) {
+    evaluatedLines = 0;
+    auto rest = incomplete;
+    rest += bytes;
+    return extend(rest);
+  }
+
+  // The number of lines evaluated by the last update
+  size_t evaluated() const { return evaluatedLines; }
+
+  // The number of non-empty complete lines
+  size_t lines() const { return completeLines; }
+
+private:
+  static void add(Answer& sum, const Answer& value) {
+    sum.part1 += value.part1;
+    sum.part2 += value.part2;
+  }
+
+  // True if the text still starts with the complete lines of the previous update. All of them are compared, because
+  // an edit may change any line. Hashing is much cheaper than evaluating the lines again.
+  bool appended(std::string_view text) const {
+    if (consumed == 0 || text.size() < consumed) {
+      return false;
+    }
+    hashing::StreamHash hash;
+    hash.add(text.substr(0, consumed));
+    return hash.value() == consumedHash.value();
+  }
+
+  // Adds the complete lines of rest, which follows the complete lines of the previous update
+  Answer extend(std::string_view rest) {
+    auto complete = rest.substr(0, rest.rfind('\n') + 1);
+    auto sum = committed;
+    auto count = completeLines;
+    for (auto line : text::lines(complete)) {
+      if (!line.empty()) {
+        add(sum, contribution(line, contributions));
+        ++count;
+      }
+    }
+    committed = sum;
+    completeLines = count;
+    consumed += complete.size();
+    consumedHash.add(complete);
+    incomplete = rest.substr(complete.size());
+    return total();
+  }
+
+  // The sums of the complete lines and the incomplete last line, if it can be evaluated already
+  Answer total() {
+    auto sum = committed;
+    if (!incomplete.empty()) {
+      try {
+        add(sum, function(incomplete));
+        ++evaluatedLines;
+      } catch (const std::exception&) {
+        // still being written, counts once it is complete
+      }
+    }
+    return sum;
+  }
+
+  void rescan(std::string_view complete) {
+    // Only the lines of the current text are kept, so the cache doesn't grow with edits
+    flat::Map<uint64_t, Answer> current;
+    Answer sum;
+    size_t count = 0;
+    for (auto line : text::lines(complete)) {
+      if (!line.empty()) {
+        add(sum, contribution(line, current));
+        ++count;
+      }
+    }
+    contributions = std::move(current);
+    committed = sum;
+    completeLines = count;
+  }
+
+  // The contribution of a non-empty line from the cache or evaluated, which is stored into target as well
+  Answer contribution(std::string_view line, flat::Map<uint64_t, Answer>& target) {
+    auto hash = hashing::hashBytes(line);
+    if (auto pos = target.find(hash); pos != target.end()) {
+      return pos->second;
+    }
+    Answer value;
+    if (auto pos = contributions.find(hash); pos != contributions.end()) {
+      value = pos->second;
+    } else {
+      value = function(line);
+      ++evaluatedLines;
+    }
+    target.try_emplace(hash, value);
+    return value;
+  }
+
+  LineFunction function;
+  flat::Map<uint64_t, Answer> contributions; // by line hash
+  Answer committed;          // the sums of all complete lines
+  size_t completeLines = 0;
+  size_t consumed = 0;       // the length of the complete lines
+  hashing::StreamHash consumedHash; // of the complete lines, which identifies the text on the next update
+  std::string incomplete;    // the bytes behind the complete lines
+  size_t evaluatedLines = 0;
+};
+
+
+/** A watched file, which stays open between updates, so that bytes appended to it are read without reading the
+ *  whole file again. It is read instead of memory mapped, because truncating a mapped file (which a watched file
+ *  may be at any time) raises SIGBUS on accessing the removed pages.
+ */
+class WatchedFile {
+public:
+  enum class Change { None, Appended, Whole };
+
+  explicit WatchedFile(std::string path) : path(std::move(path)) {}
+
+  /** Reads the changes since the last call into content: only the appended bytes if the file is still the same
+   *  one and only grew, otherwise the whole file. Nothing is read if it is unchanged.
+   *  Throws std::runtime_error if the file cannot be read.
+   */
+  Change read(std::string& content) {
+    auto current = status();
+    if (file.is_open() && current.device == last.device && current.inode == last.inode && current.size >= last.size) {
+      if (current.size == last.size && current.time == last.time) {
+        return Change::None;
+      }
+      if (current.size > last.size && readAppended(current.size - last.size, content)) {
+        last.time = current.time;
+        return Change::Appended;
+      }
+    }
+
+    // Shrunk, replaced or changed without growing
+    file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("Failed to open " + path);
+    }
+    content.clear();
+    read(current.size, content);
+    last = current;
+    last.size = content.size(); // the file may have shrunk since its status was taken
+    boundary.assign(content, content.size() - std::min(content.size(), BoundarySize));
+    return Change::Whole;
+  }
+
+  // Reads the whole file on the next call, e.g. after its changes couldn't be applied
+  void reset() { file.close(); }
+
+private:
+  struct Status {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    uintmax_t size = 0;
+    std::filesystem::file_time_type time;
+  };
+
+  // The bytes in front of the read ones which are compared before reading appended bytes, so that a file which was
+  // rewritten in place and grew on the way (e.g. truncated and written again before the change was noticed) is
+  // read again as a whole
+  static constexpr size_t BoundarySize = 64;
+
+  Status status() const {
+    Status status;
+#ifndef _WIN32
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+      throw std::runtime_error("Failed to stat " + path);
+    }
+    status.device = static_cast<uint64_t>(info.st_dev);
+    status.inode = static_cast<uint64_t>(info.st_ino);
+#endif // no inode numbers on Windows, a replaced file is noticed by its size, time or boundary
+    status.size = std::filesystem::file_size(path);
+    status.time = std::filesystem::last_write_time(path);
+    return status;
+  }
+
+  // Reads count bytes behind the read ones if the boundary is unchanged. Bytes appended since the status was taken
+  // are left for the next change, which is noticed for them.
+  bool readAppended(uintmax_t count, std::string& content) {
+    file.clear(); // the end of the file was reached before
+    file.seekg(static_cast<std::streamoff>(last.size - boundary.size()));
+    std::string before(boundary.size(), '\0');
+    if (!file.read(before.data(), static_cast<std::streamsize>(before.size())) || before != boundary) {
+      return false;
+    }
+    content.clear();
+    read(count, content);
+    last.size += content.size();
+    boundary += content;
+    boundary.erase(0, boundary.size() - std::min(boundary.size(), BoundarySize));
+    return true;
+  }
+
+  // Appends up to count bytes from the current position to content
+  void read(uintmax_t count, std::string& content) {
+    char chunk[1 << 16];
+    while (count > 0 && (file.read(chunk, static_cast<std::streamsize>(std::min<uintmax_t>(count, sizeof(chunk)))) || file.gcount())) {
+      content.append(chunk, static_cast<size_t>(file.gcount()));
+      count -= static_cast<uintmax_t>(file.gcount());
+    }
+  }
+
+  std::string path;
+  std::ifstream file;
+  Status last;          // of the read bytes
+  std::string boundary; // the last read bytes
+};
+
+
+/** Prints the sums of the lines of the file and updates them whenever the file changes, until the process is
+ *  interrupted. On Linux the directory of the file is watched with inotify, so replacing the file (like editors
+ *  do on saving) is noticed as well. Elsewhere the modification time and size are polled.
+ *  Part 2 is only printed if it is a sum over the lines as well.
+ */
+inline int run(const std::string& path, LineFunction function, bool withPart2 = true) {
+  LineSums sums(std::move(function));
+  WatchedFile watched(path);
+  std::string content; // reused, so that reading doesn't reallocate each time
+  auto update = [&] {
+    try {
+      auto start = std::chrono::steady_clock::now();
+      Answer answer;
+      switch (watched.read(content)) {
+        case WatchedFile::Change::None:
+          return; // e.g. closing after the write which was already read
+        case WatchedFile::Change::Appended:
+          answer = sums.append(content);
+          break;
+        case WatchedFile::Change::Whole:
+          answer = sums.update(content);
+          break;
+      }
+      auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      std::cout << "Part 1: " << answer.part1 << "\n";
+      if (withPart2) {
+        std::cout << "Part 2: " << answer.part2 << "\n";
+      }
+      std::cout << std::format("Evaluated {} of {} lines in {:.3f}ms\n", sums.evaluated(), sums.lines(), time) << std::flush;
+    } catch (const std::exception& e) {
+      watched.reset(); // the sums weren't updated with what was read
+      std::cerr << e.what() << "\n"; // e.g. the file is being replaced, the next change updates again
+    }
+  };
+  update();
+
+#ifdef __linux__
+  auto file = std::filesystem::absolute(path);
+  auto name = file.filename().string();
+  int notify = inotify_init1(IN_CLOEXEC);
+  if (notify < 0 || inotify_add_watch(notify, file.parent_path().c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) {
+    throw std::runtime_error("Failed to watch " + file.parent_path().string());
+  }
+
+  alignas(inotify_event) char buffer[1 << 16];
+  for (;;) {
+    auto size = read(notify, buffer, sizeof(buffer)); // blocks until the next events
+    if (size <= 0) {
+      break;
+    }
+    // One update for all events read at once, e.g. the many modifications of one large write
+    bool changed = false;
+    for (auto pos = buffer; pos < buffer + size;) {
+      auto event = reinterpret_cast<const inotify_event*>(pos);
+      changed |= event->len && name == event->name;
+      pos += sizeof(inotify_event) + event->len;
+    }
+    if (changed) {
+      update();
+    }
+  }
+  close(notify);
+#else
+  std::filesystem::file_time_type lastWrite;
+  uintmax_t lastSize = 0;
+  for (;;) {
+    std::error_code error;
+    auto write = std::filesystem::last_write_time(path, error);
+    auto size = std::filesystem::file_size(path, error);
+    if (!error && (write != lastWrite || size != lastSize)) {
+      lastWrite = write;
+      lastSize = size;
+      update();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+#endif
+  return 0;
+}
+
+}